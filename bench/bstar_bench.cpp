@@ -0,0 +1,441 @@
+#include <bits/stdc++.h>
+
+#include "b_star_tree_refactored.h"
+
+/*================================================*\
+
+  Benchmark suite,
+  `bstar_bench --workload A,C --dist zipf --fanout 64,145 --format json`.
+
+  Every (workload, distribution, fanout) triple is
+  one run on a fresh tree: the records are loaded,
+  then the operations are timed one by one.
+  A run reports ops/s, latency percentiles and
+  the peak RSS of the run.
+
+\*================================================*/
+
+using ll = long long;
+
+template<std::size_t M>
+using bench_tree = b_star_tree<ll, ll, M, b_star_inline_node<ll, ll, M>>;
+
+struct bench_config {
+  std::string workload{"A"};
+  std::string dist{"uniform"};
+  std::size_t fanout{145};
+  std::size_t records{1000000};
+  std::size_t ops{1000000};
+  std::size_t scan_width{100};
+  double theta{0.99};
+  std::uint64_t seed{1337};
+};
+
+struct bench_result {
+  double seconds{};
+  std::size_t ops{};
+  std::uint64_t p50{}, p99{}, p999{}, max{};
+  std::size_t peak_rss_kb{};
+  ll checksum{};
+};
+
+/*================================================*\
+    Key choosers
+\*================================================*/
+
+// Gray et al., "Quickly generating billion-record synthetic databases", as in YCSB.
+struct zipf_gen {
+  std::uint64_t n{};
+  double theta{}, alpha{}, zetan{}, eta{}, half{};
+
+  zipf_gen() = default;
+
+  zipf_gen(std::uint64_t items, double t) : theta{t} {
+    alpha = 1.0 / (1.0 - theta);
+    half = std::pow(0.5, theta);
+    grow(items);
+  }
+
+  // zeta is a prefix sum, so a longer domain only adds its new terms, as YCSB does for "latest".
+  void grow(std::uint64_t items) {
+    for (std::uint64_t i = n + 1; i <= items; i++) {
+      zetan += 1.0 / std::pow(static_cast<double>(i), theta);
+    }
+    n = items;
+    eta = (1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - (1.0 + half) / zetan);
+  }
+
+  // rank 0 is the most popular.
+  std::uint64_t next(std::mt19937_64 &gen) {
+    double u{std::uniform_real_distribution<double>{0.0, 1.0}(gen)};
+    double uz{u * zetan};
+    if (uz < 1.0) return 0;
+    if (uz < 1.0 + half) return 1;
+    return std::min(n - 1, static_cast<std::uint64_t>(static_cast<double>(n) * std::pow(eta * u - eta + 1.0, alpha)));
+  }
+};
+
+// spreads the popular ranks over the key space, otherwise they would share a leaf.
+std::uint64_t scramble(std::uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  return x;
+}
+
+struct key_chooser {
+  enum kind_t { SEQ, UNIFORM, ZIPF } kind{};
+  std::uint64_t n{}, next_seq{};
+  zipf_gen zipf{};
+
+  key_chooser(const std::string &dist, std::uint64_t items, double theta) : n{items} {
+    if (dist == "seq") {
+      kind = SEQ;
+    } else if (dist == "zipf") {
+      kind = ZIPF;
+      zipf = zipf_gen{items, theta};
+    } else {
+      kind = UNIFORM;
+    }
+  }
+
+  ll next(std::mt19937_64 &gen) {
+    switch (kind) {
+    case SEQ:
+      return static_cast<ll>(next_seq++ % n);
+    case ZIPF:
+      return static_cast<ll>(scramble(zipf.next(gen)) % n);
+    default:
+      return static_cast<ll>(gen() % n);
+    }
+  }
+
+  // YCSB D, drawn over the `cnt` records inserted so far, the most recent is the most popular.
+  ll latest(std::mt19937_64 &gen, std::uint64_t cnt) {
+    if (kind != ZIPF) return static_cast<ll>(cnt - 1 - gen() % cnt);
+    if (zipf.n < cnt) zipf.grow(cnt);
+    return static_cast<ll>(cnt - 1 - zipf.next(gen));
+  }
+};
+
+/*================================================*\
+    Measurement
+\*================================================*/
+
+// 16 linear buckets per power of two, a recorded value is at most 1/16 above the bucket it lands in.
+struct latency_hist {
+  std::array<std::uint64_t, 16 + 60 * 16> cnt{};
+  std::uint64_t total{}, max{};
+
+  static std::size_t bucket_(std::uint64_t v) noexcept {
+    if (v < 16) return v;
+    int e{63 - __builtin_clzll(v)};
+    return 16 + static_cast<std::size_t>(e - 4) * 16 + ((v >> (e - 4)) & 15);
+  }
+
+  static std::uint64_t low_(std::size_t b) noexcept {
+    if (b < 16) return b;
+    std::size_t e{(b - 16) / 16 + 4};
+    return (16 + (b - 16) % 16) << (e - 4);
+  }
+
+  void add(std::uint64_t ns) noexcept {
+    cnt[bucket_(ns)]++;
+    total++;
+    max = std::max(max, ns);
+  }
+
+  std::uint64_t percentile(double p) const noexcept {
+    std::uint64_t want{static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(total)))}, seen{};
+    for (std::size_t b = 0; b < cnt.size(); b++) {
+      seen += cnt[b];
+      if (seen >= want && seen > 0) return low_(b);
+    }
+    return max;
+  }
+};
+
+// the kernel keeps the high-water mark, writing 5 to `clear_refs` resets it (Linux 4.0+).
+void reset_peak_rss() {
+  if (std::FILE *f{std::fopen("/proc/self/clear_refs", "w")}) {
+    std::fputs("5", f);
+    std::fclose(f);
+  }
+}
+
+std::size_t peak_rss_kb() {
+  std::size_t kb{};
+  if (std::FILE *f{std::fopen("/proc/self/status", "r")}) {
+    char line[256];
+    while (std::fgets(line, sizeof(line), f)) {
+      if (std::sscanf(line, "VmHWM: %zu kB", &kb) == 1) break;
+    }
+    std::fclose(f);
+  }
+  return kb;
+}
+
+std::uint64_t now_ns() {
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<std::uint64_t>(ts.tv_sec) * 1'000'000'000ULL + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+/*================================================*\
+    Workloads
+\*================================================*/
+
+// read / update / insert / scan / read-modify-write shares in percent, YCSB core workloads A-F.
+struct op_mix {
+  int read, update, insert, scan, rmw;
+};
+
+std::optional<op_mix> mix_for(const std::string &w) {
+  if (w == "A") return op_mix{50, 50, 0, 0, 0};
+  if (w == "B") return op_mix{95, 5, 0, 0, 0};
+  if (w == "C") return op_mix{100, 0, 0, 0, 0};
+  if (w == "D") return op_mix{95, 0, 5, 0, 0};
+  if (w == "E") return op_mix{0, 0, 5, 95, 0};
+  if (w == "F") return op_mix{50, 0, 0, 0, 50};
+  if (w == "scan") return op_mix{0, 0, 0, 100, 0};
+  return std::nullopt;
+}
+
+template<std::size_t M>
+bench_result run_workload(const bench_config &cfg) {
+  bench_tree<M> t{};
+  bench_result res{};
+  latency_hist hist{};
+  std::mt19937_64 gen{cfg.seed};
+  key_chooser chooser{cfg.dist, cfg.records, cfg.theta};
+
+  reset_peak_rss();
+  // records are keys 0 .. records - 1, loaded in order for `seq` and shuffled otherwise.
+  std::vector<ll> order(cfg.records);
+  std::iota(order.begin(), order.end(), 0);
+  if (cfg.dist != "seq") std::shuffle(order.begin(), order.end(), gen);
+
+  std::uint64_t beg{now_ns()};
+  if (cfg.workload == "load") {
+    for (ll k : order) {
+      std::uint64_t t0{now_ns()};
+      t.insert(k, k);
+      hist.add(now_ns() - t0);
+    }
+    res.ops = order.size();
+  } else {
+    for (ll k : order) {
+      t.insert(k, k);
+    }
+    std::vector<ll>{}.swap(order);
+    op_mix mix{*mix_for(cfg.workload)};
+    std::uint64_t cnt{cfg.records};
+    ll sum{};
+    beg = now_ns();
+    for (std::size_t i = 0; i < cfg.ops; i++) {
+      int dice{static_cast<int>(gen() % 100)};
+      // keys are drawn before the clock starts.
+      ll k{cfg.workload == "D" ? chooser.latest(gen, cnt) : chooser.next(gen)};
+      std::size_t width{cfg.workload == "E" ? 1 + gen() % cfg.scan_width : cfg.scan_width};
+      std::uint64_t t0{now_ns()};
+      if ((dice -= mix.read) < 0) {
+        if (ll *v{t.find_single(k)}) sum += *v;
+      } else if ((dice -= mix.update) < 0) {
+        if (ll *v{t.find_single(k)}) *v = static_cast<ll>(i);
+      } else if ((dice -= mix.insert) < 0) {
+        t.insert(static_cast<ll>(cnt), static_cast<ll>(cnt));
+        cnt++;
+      } else if ((dice -= mix.scan) < 0) {
+        t.for_each_in_range(k, k + static_cast<ll>(width), [&](const ll &, ll *v) { sum += *v; });
+      } else {
+        if (ll *v{t.find_single(k)}) *v += 1;
+      }
+      hist.add(now_ns() - t0);
+    }
+    res.ops = cfg.ops;
+    res.checksum = sum;
+  }
+  res.seconds = static_cast<double>(now_ns() - beg) / 1e9;
+  res.p50 = hist.percentile(0.50);
+  res.p99 = hist.percentile(0.99);
+  res.p999 = hist.percentile(0.999);
+  res.max = hist.max;
+  res.peak_rss_kb = peak_rss_kb();
+  return res;
+}
+
+// fanouts instantiated at compile time, `--fanout` picks among them.
+constexpr std::pair<std::size_t, bench_result (*)(const bench_config &)> FANOUTS[]{
+    {16, run_workload<16>},
+    {64, run_workload<64>},
+    {145, run_workload<145>},
+    {255, run_workload<255>},
+};
+
+/*================================================*\
+    Command line and output
+\*================================================*/
+
+std::vector<std::string> split(const std::string &s) {
+  std::vector<std::string> out{};
+  std::stringstream in{s};
+  for (std::string item; std::getline(in, item, ',');) {
+    if (!item.empty()) out.emplace_back(item);
+  }
+  return out;
+}
+
+// the whole argument or `std::invalid_argument`, `std::stoull` alone stops at the first bad character.
+std::uint64_t parse_count(const std::string &s) {
+  std::size_t used{};
+  std::uint64_t v{std::stoull(s, &used)};
+  if (used != s.size() || s.front() == '-') throw std::invalid_argument{s};
+  return v;
+}
+
+double parse_real(const std::string &s) {
+  std::size_t used{};
+  double v{std::stod(s, &used)};
+  if (used != s.size()) throw std::invalid_argument{s};
+  return v;
+}
+
+void usage(const char *prog) {
+  std::fprintf(stderr,
+               "usage: %s [options], lists are comma separated\n"
+               "  --workload  load,A,B,C,D,E,F,scan   (A)\n"
+               "  --dist      seq,uniform,zipf         (uniform)\n"
+               "  --fanout    16,64,145,255 or all     (145)\n"
+               "  --records   N                        (1000000)\n"
+               "  --ops       N                        (1000000)\n"
+               "  --scan-width W, keys per scan, the maximum for E (100)\n"
+               "  --theta     zipf skew                (0.99)\n"
+               "  --seed      S                        (1337)\n"
+               "  --format    text,json,csv            (text)\n",
+               prog);
+}
+
+void print_row(const std::string &format, const bench_config &cfg, const bench_result &r, bool first, bool last) {
+  double ops_s{static_cast<double>(r.ops) / r.seconds};
+  if (format == "json") {
+    std::printf("%s  {\"workload\": \"%s\", \"dist\": \"%s\", \"fanout\": %zu, \"records\": %zu, \"ops\": %zu, "
+                "\"scan_width\": %zu, \"seconds\": %.6f, \"ops_per_s\": %.1f, \"p50_ns\": %" PRIu64
+                ", \"p99_ns\": %" PRIu64 ", \"p999_ns\": %" PRIu64 ", \"max_ns\": %" PRIu64
+                ", \"peak_rss_kb\": %zu, \"checksum\": %lld}%s\n",
+                first ? "[\n" : "", cfg.workload.c_str(), cfg.dist.c_str(), cfg.fanout, cfg.records, r.ops,
+                cfg.scan_width, r.seconds, ops_s, r.p50, r.p99, r.p999, r.max, r.peak_rss_kb, r.checksum,
+                last ? "\n]" : ",");
+  } else if (format == "csv") {
+    if (first) {
+      std::puts("workload,dist,fanout,records,ops,scan_width,seconds,ops_per_s,p50_ns,p99_ns,p999_ns,max_ns,"
+                "peak_rss_kb,checksum");
+    }
+    std::printf("%s,%s,%zu,%zu,%zu,%zu,%.6f,%.1f,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%zu,%lld\n",
+                cfg.workload.c_str(), cfg.dist.c_str(), cfg.fanout, cfg.records, r.ops, cfg.scan_width, r.seconds,
+                ops_s, r.p50, r.p99, r.p999, r.max, r.peak_rss_kb, r.checksum);
+  } else {
+    if (first) {
+      std::printf("%-8s %-8s %6s %12s %9s %9s %9s %12s %10s\n", "workload", "dist", "M", "ops/s", "p50 ns", "p99 ns",
+                  "p999 ns", "max ns", "rss MiB");
+    }
+    std::printf("%-8s %-8s %6zu %12.0f %9" PRIu64 " %9" PRIu64 " %9" PRIu64 " %12" PRIu64 " %10.1f\n",
+                cfg.workload.c_str(), cfg.dist.c_str(), cfg.fanout, ops_s, r.p50, r.p99, r.p999, r.max,
+                static_cast<double>(r.peak_rss_kb) / 1024.0);
+  }
+  std::fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+  bench_config cfg{};
+  std::string workloads{cfg.workload}, dists{cfg.dist}, fanouts{"145"}, format{"text"};
+
+  std::vector<std::size_t> ms{};
+  // a malformed number is a usage error like any other.
+  try {
+    for (int i = 1; i < argc; i++) {
+      std::string opt{argv[i]};
+      if (opt == "--help" || opt == "-h" || i + 1 == argc) {
+        usage(argv[0]);
+        return opt == "--help" || opt == "-h" ? 0 : 1;
+      }
+      std::string val{argv[++i]};
+      if (opt == "--workload") {
+        workloads = val;
+      } else if (opt == "--dist") {
+        dists = val;
+      } else if (opt == "--fanout") {
+        fanouts = val;
+      } else if (opt == "--records") {
+        cfg.records = parse_count(val);
+      } else if (opt == "--ops") {
+        cfg.ops = parse_count(val);
+      } else if (opt == "--scan-width") {
+        cfg.scan_width = std::max<std::size_t>(1, parse_count(val));
+      } else if (opt == "--theta") {
+        cfg.theta = parse_real(val);
+      } else if (opt == "--seed") {
+        cfg.seed = parse_count(val);
+      } else if (opt == "--format") {
+        format = val;
+      } else {
+        usage(argv[0]);
+        return 1;
+      }
+    }
+
+    for (const std::string &f : split(fanouts)) {
+      if (f == "all") {
+        for (const auto &[m, run] : FANOUTS) {
+          ms.emplace_back(m);
+        }
+      } else {
+        ms.emplace_back(parse_count(f));
+      }
+    }
+  } catch (const std::logic_error &) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  // validated up front, so a typo does not surface halfway through a long matrix.
+  if (format != "text" && format != "json" && format != "csv") {
+    std::fprintf(stderr, "unknown format %s\n", format.c_str());
+    return 1;
+  }
+  std::vector<std::tuple<std::string, std::string, std::size_t>> runs{};
+  for (const std::string &w : split(workloads)) {
+    if (w != "load" && !mix_for(w)) {
+      std::fprintf(stderr, "unknown workload %s\n", w.c_str());
+      return 1;
+    }
+    for (const std::string &d : split(dists)) {
+      if (d != "seq" && d != "uniform" && d != "zipf") {
+        std::fprintf(stderr, "unknown distribution %s\n", d.c_str());
+        return 1;
+      }
+      if (d == "zipf" && (cfg.theta <= 0.0 || cfg.theta == 1.0)) {
+        std::fprintf(stderr, "theta has to be positive and not 1\n");
+        return 1;
+      }
+      for (std::size_t m : ms) {
+        if (std::none_of(std::begin(FANOUTS), std::end(FANOUTS), [&](const auto &f) { return f.first == m; })) {
+          std::fprintf(stderr, "fanout %zu is not compiled in\n", m);
+          return 1;
+        }
+        runs.emplace_back(w, d, m);
+      }
+    }
+  }
+  if (cfg.records == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  for (std::size_t i = 0; i < runs.size(); i++) {
+    std::tie(cfg.workload, cfg.dist, cfg.fanout) = runs[i];
+    auto run{
+        std::find_if(std::begin(FANOUTS), std::end(FANOUTS), [&](const auto &f) { return f.first == cfg.fanout; })};
+    bench_result r{run->second(cfg)};
+    print_row(format, cfg, r, i == 0, i + 1 == runs.size());
+  }
+}
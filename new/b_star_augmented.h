@@ -0,0 +1,279 @@
+#pragma once
+#include "b_star_tree_refactored.h"
+
+/*================================================*\
+
+  Order statistics and range aggregates,
+  `b_star_augmented_tree`.
+
+  An index node keeps, next to each child pointer,
+  the summary of that subtree: how many keys it
+  holds and a monoid folded over its entries, e.g.
+  `b_sum_monoid`. Summaries move along with the
+  child pointers when keys are redistributed and
+  are refreshed where a child changes, so
+
+  - `rank()` / `select()` / `count_range()` and
+    `aggregate_range()` take one descent per bound,
+    whole children in between count by summary,
+  - writes refresh the path to the leaf they touch
+    on the way back up from it.
+
+  Values are inline, a value changed through a
+  pointer the tree handed out leaves its summaries
+  stale, `insert_or_assign()` or `update()` do not.
+
+\*================================================*/
+
+template<typename val_type>
+struct b_sum_monoid {
+  using value_type = val_type;
+  static value_type identity() noexcept {
+    return value_type{};
+  }
+  template<typename key_type>
+  static value_type of(const key_type &, const val_type &v) noexcept {
+    return v;
+  }
+  static value_type combine(const value_type &a, const value_type &b) noexcept {
+    return a + b;
+  }
+};
+
+template<typename val_type>
+struct b_min_monoid {
+  using value_type = val_type;
+  static value_type identity() noexcept {
+    return std::numeric_limits<val_type>::max();
+  }
+  template<typename key_type>
+  static value_type of(const key_type &, const val_type &v) noexcept {
+    return v;
+  }
+  static value_type combine(const value_type &a, const value_type &b) noexcept {
+    return std::min(a, b);
+  }
+};
+
+template<typename val_type>
+struct b_max_monoid {
+  using value_type = val_type;
+  static value_type identity() noexcept {
+    return std::numeric_limits<val_type>::lowest();
+  }
+  template<typename key_type>
+  static value_type of(const key_type &, const val_type &v) noexcept {
+    return v;
+  }
+  static value_type combine(const value_type &a, const value_type &b) noexcept {
+    return std::max(a, b);
+  }
+};
+
+// a subtree, or a part of one: its key count and the monoid over its entries in key order.
+template<typename value_type>
+struct b_summary {
+  std::size_t cnt;
+  value_type agg;
+};
+
+// the summaries share the union with the leaf values, in `idx.sum[]`, and leaves end before them.
+template<typename key_type, typename val_type, std::size_t M, typename monoid = b_sum_monoid<val_type>>
+struct b_star_augmented_node
+    : public b_base_node<key_type, val_type, M, b_star_augmented_node<key_type, val_type, M, monoid>, val_type,
+                         b_summary<typename monoid::value_type>> {
+  using monoid_t = monoid;
+  using summary_t = b_summary<typename monoid::value_type>;
+  static_assert(std::is_trivially_copyable_v<summary_t>, "summaries are moved with memmove");
+
+  static constexpr bool AUGMENTED = true;
+
+  // the union comes last, a leaf stops after the longer of its values and the child pointers.
+  static constexpr std::size_t leaf_bytes_() noexcept {
+    using self = b_star_augmented_node;
+    std::size_t arm{std::max(sizeof(self::leaf), sizeof(self::idx.key_ptr))};
+    return b_round_up_(sizeof(self) - sizeof(self::idx) + arm, alignof(self));
+  }
+
+  static summary_t identity_() noexcept {
+    return {0, monoid::identity()};
+  }
+
+  static summary_t combine_(const summary_t &a, const summary_t &b) noexcept {
+    return {a.cnt + b.cnt, monoid::combine(a.agg, b.agg)};
+  }
+
+  // entries [from, to) of a leaf.
+  summary_t fold_(std::size_t from, std::size_t to) const noexcept {
+    summary_t s{to - from, monoid::identity()};
+    for (std::size_t i = from; i < to; i++) {
+      s.agg = monoid::combine(s.agg, monoid::of(this->key_at_(i), this->leaf.data[i]));
+    }
+    return s;
+  }
+
+  // the whole subtree, from the summaries of an index node or the entries of a leaf.
+  static summary_t total_(const b_star_augmented_node *cur) noexcept {
+    if (cur->is_leaf) return cur->fold_(0, cur->key_cnt);
+    summary_t s{identity_()};
+    for (std::size_t i = 0; i <= cur->key_cnt; i++) {
+      s = combine_(s, cur->idx.sum[i]);
+    }
+    return s;
+  }
+};
+
+template<typename key_type, typename val_type, std::size_t M,
+         typename node_type = b_star_augmented_node<key_type, val_type, M>,
+         typename alloc_type = b_node_split_arena<node_type>, typename stats_type = b_no_stats>
+class b_star_augmented_tree : public b_star_tree<key_type, val_type, M, node_type, alloc_type, stats_type> {
+  static_assert(node_type::AUGMENTED, "needs summaries in the index nodes, e.g. `b_star_augmented_node`");
+
+protected:
+  using base = b_star_tree<key_type, val_type, M, node_type, alloc_type, stats_type>;
+  using typename base::slot_type;
+  using summary_type = typename node_type::summary_t;
+  using agg_type = typename node_type::monoid_t::value_type;
+  using typename base::descent;
+  using base::root;
+
+  // after a write to the leaf `path` ends in, each node on it sums the child it leads to again, bottom up.
+  // the fixes on the way down keep the summaries of the children they touch.
+  void refresh_path_(const descent &path) noexcept {
+    for (std::size_t d = path.depth; d-- > 0;) {
+      this->refresh_sum_(path.node[d], path.at[d]);
+    }
+  }
+
+  // the leaf for `k` as `insert()` finds it, with the way down.
+  node_type *insert_path_(const key_type &k, descent &path) noexcept {
+    if (this->root_overflow_(root)) {
+      this->fix_root_overflow_();
+    }
+    return this->insert_down_to_leaf(root, k, nullptr, &path);
+  }
+
+  // the entries of [low, high) under `cur`, a null bound leaves that side open.
+  // the children between the two holding the bounds count by their summaries.
+  static summary_type summarize_(node_type *cur, const key_type *low, const key_type *high) noexcept {
+    if (cur->is_leaf) {
+      std::size_t from{low ? cur->find_data_ptr_index_(*low) : 0};
+      std::size_t to{high ? cur->find_data_ptr_index_(*high) : cur->key_cnt};
+      return from < to ? cur->fold_(from, to) : node_type::identity_();
+    }
+    std::size_t a{low ? cur->find_data_ptr_index_(*low) : 0};
+    std::size_t b{high ? cur->find_data_ptr_index_(*high) : cur->key_cnt};
+    if (a == b) return summarize_(cur->idx.key_ptr[a], low, high);
+    summary_type s{low ? summarize_(cur->idx.key_ptr[a], low, nullptr) : cur->idx.sum[a]};
+    for (std::size_t i = a + 1; i < b; i++) {
+      s = node_type::combine_(s, cur->idx.sum[i]);
+    }
+    return node_type::combine_(s, high ? summarize_(cur->idx.key_ptr[b], nullptr, high) : cur->idx.sum[b]);
+  }
+
+public:
+  using typename base::cursor;
+
+  b_star_augmented_tree() = default;
+
+  template<std::forward_iterator iter>
+  b_star_augmented_tree(iter first, iter last, double fill_factor = 1.0) : base{first, last, fill_factor} {}
+
+  // the writes below descend as the plain tree does, but keep the path. `insert()` skips the shortcut to the last
+  // leaf, whose ancestors need refreshing all the same.
+  bool insert(const key_type &k, slot_type v) noexcept {
+    descent path{};
+    if (!this->insert_leaf(insert_path_(k, path), k, v)) return false;
+    refresh_path_(path);
+    return true;
+  }
+
+  bool erase(const key_type &k) noexcept {
+    if (this->root_underflow_()) {
+      this->fix_root_underflow_();
+    }
+    descent path{};
+    if (!this->erase_leaf(this->erase_down_to_leaf(root, k, nullptr, &path), k)) return false;
+    refresh_path_(path);
+    return true;
+  }
+
+  std::pair<val_type *, bool> try_emplace(const key_type &k, slot_type v) noexcept {
+    descent path{};
+    node_type *cur{insert_path_(k, path)};
+    auto [idx, inserted]{this->emplace_leaf_(cur, k, v)};
+    if (inserted) refresh_path_(path);
+    return {cur->val_ptr_(idx), inserted};
+  }
+
+  bool insert_or_assign(const key_type &k, slot_type v) noexcept {
+    descent path{};
+    node_type *cur{insert_path_(k, path)};
+    auto [idx, inserted]{this->emplace_leaf_(cur, k, v)};
+    if (!inserted) cur->leaf.data[idx] = v;
+    refresh_path_(path);
+    return inserted;
+  }
+
+  template<typename updater>
+  bool update(const key_type &k, slot_type init, updater &&fn) {
+    descent path{};
+    node_type *cur{insert_path_(k, path)};
+    auto [idx, inserted]{this->emplace_leaf_(cur, k, init)};
+    fn(cur->val_ptr_(idx));
+    refresh_path_(path);
+    return !inserted;
+  }
+
+  // the hint saves nothing here, the ancestors of its leaf are found by a descent anyway.
+  cursor insert_hint(cursor, const key_type &k, slot_type v) noexcept {
+    descent path{};
+    node_type *cur{insert_path_(k, path)};
+    cursor it{cur, this->emplace_leaf_(cur, k, v).first};
+    refresh_path_(path);
+    return it;
+  }
+
+  std::size_t size() const noexcept {
+    return node_type::total_(root).cnt;
+  }
+
+  // how many keys are `< k`.
+  std::size_t rank(const key_type &k) const noexcept {
+    return summarize_(root, nullptr, &k).cnt;
+  }
+
+  // the key of rank `i`, `end()` past the last one.
+  cursor select(std::size_t i) const noexcept {
+    node_type *cur{root};
+    while (!cur->is_leaf) {
+      std::size_t j{0};
+      while (j < cur->key_cnt && i >= cur->idx.sum[j].cnt) {
+        i -= cur->idx.sum[j++].cnt;
+      }
+      cur = cur->idx.key_ptr[j];
+    }
+    return i < cur->key_cnt ? cursor{cur, i} : this->end();
+  }
+
+  // how many keys are in [low, high).
+  std::size_t count_range(const key_type &low, const key_type &high) const noexcept {
+    return low < high ? summarize_(root, &low, &high).cnt : 0;
+  }
+
+  // the monoid over [low, high) in key order, its identity for an empty range.
+  agg_type aggregate_range(const key_type &low, const key_type &high) const noexcept {
+    return low < high ? summarize_(root, &low, &high).agg : node_type::identity_().agg;
+  }
+
+  // the monoid over every entry.
+  agg_type aggregate() const noexcept {
+    return node_type::total_(root).agg;
+  }
+
+  // these write many leaves with no path to refresh.
+  template<std::random_access_iterator iter>
+  std::size_t insert_batch(iter first, iter last, bool sorted = false) = delete;
+  template<std::random_access_iterator iter>
+  std::size_t erase_batch(iter first, iter last, bool sorted = false) = delete;
+};
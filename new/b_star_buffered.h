@@ -0,0 +1,611 @@
+#pragma once
+#include "b_star_tree_refactored.h"
+
+/*================================================*\
+
+  Write-optimized index nodes,
+  `b_star_buffered_tree`, a B-epsilon tree over the
+  same B* pivots.
+
+  An index node keeps a buffer of pending writes,
+  messages kept by the child they go to, in key
+  order. A write is a message into the root's
+  buffer, one node searched. Once a buffer holds
+  `buffer_limit` messages, the ones for the child
+  most of them go to move a level down in one
+  batch, and into the leaves from the last index
+  level.
+
+  - the pivots are the tree's own: a child is fixed
+    before a batch goes in as `insert()` / `erase()`
+    would on their way down, and the messages for
+    the children a fix touched, and in their own
+    buffers, are sorted out again by the new
+    separators,
+  - a message sits above any older one for the same
+    key, `find_single()` searches one part of each
+    buffer on its way down and stops at the first
+    message that decides, the leaf last,
+  - writes are blind, `insert()` keeps an older
+    value and nothing tells whether the key was
+    there.
+
+  Range reads, cursors, `save()` and `freeze()` read
+  the leaves, they `flush()` first.
+
+\*================================================*/
+
+enum class b_op : std::uint8_t {
+  // put unless the key is there, `insert()`.
+  INSERT,
+  // put over any older value, `insert_or_assign()`.
+  ASSIGN,
+  ERASE
+};
+
+template<typename key_type, typename slot_type>
+struct b_message {
+  key_type key;
+  slot_type val;
+  b_op op;
+
+  // `newer` on top of this one, for the same key.
+  void absorb_(const b_message &newer) {
+    if (newer.op != b_op::INSERT) {
+      *this = newer;
+    } else if (op == b_op::ERASE) {
+      *this = {newer.key, newer.val, b_op::ASSIGN};
+    }
+  }
+};
+
+// the pending messages of an index node, by the child they go to.
+template<typename key_type, typename slot_type, std::size_t M>
+struct b_buffer {
+  using message_t = b_message<key_type, slot_type>;
+  // `part[i]` for child i, in key order.
+  std::vector<message_t> part[M];
+  std::size_t total{};
+};
+
+template<typename key_type, typename val_type, std::size_t M, typename slot_type = val_type *>
+struct b_buffered_node
+    : public b_base_node<key_type, val_type, M, b_buffered_node<key_type, val_type, M, slot_type>, slot_type> {
+  using buffer_t = b_buffer<key_type, slot_type, M>;
+  using message_t = typename buffer_t::message_t;
+
+  // pending messages of an index node, null while it has none. see `b_buffered_alloc`.
+  buffer_t *buf;
+};
+
+// Hands out nodes without a buffer, and frees the buffer of a node it takes back.
+template<typename node_type, typename inner_type = b_node_default_alloc<node_type>>
+class b_buffered_alloc {
+  inner_type inner{};
+
+public:
+  node_type *allocate() {
+    node_type *n{inner.allocate()};
+    n->buf = nullptr;
+    return n;
+  }
+
+  void deallocate(node_type *n) noexcept {
+    delete n->buf;
+    inner.deallocate(n);
+  }
+};
+
+template<typename key_type, typename val_type, std::size_t M, typename node_type = b_buffered_node<key_type, val_type, M>,
+         typename alloc_type = b_buffered_alloc<node_type>, typename stats_type = b_no_stats>
+class b_star_buffered_tree : public b_star_tree<key_type, val_type, M, node_type, alloc_type, stats_type> {
+protected:
+  using base = b_star_tree<key_type, val_type, M, node_type, alloc_type, stats_type>;
+  using typename base::slot_type;
+  using message_type = typename node_type::message_t;
+  using buffer_type = typename node_type::buffer_t;
+  using batch_type = std::vector<message_type>;
+  using base::count_;
+  using base::root;
+
+  // a buffer holding this many messages sends a batch down, see `set_buffer_limit()`.
+  std::size_t buffer_limit{M};
+  // messages in all buffers.
+  std::size_t pending_{};
+
+  static bool key_less_(const message_type &m, const key_type &k) noexcept {
+    return m.key < k;
+  }
+
+  static std::size_t pending_in_(const node_type *cur) noexcept {
+    return cur->buf ? cur->buf->total : 0;
+  }
+
+  static val_type *message_val_(message_type *m) noexcept {
+    if constexpr (node_type::INLINE_VAL) {
+      return &m->val;
+    } else {
+      return m->val;
+    }
+  }
+
+  // `m` into the buffer of `cur`, on top of an older message for its key. returns whether the key was new there.
+  static bool put_(node_type *cur, message_type &&m) {
+    if (!cur->buf) cur->buf = new buffer_type{};
+    batch_type &part{cur->buf->part[cur->find_idx_ptr_index_(m.key)]};
+    auto it{std::lower_bound(part.begin(), part.end(), m.key, key_less_)};
+    if (it != part.end() && !(m.key < it->key)) {
+      it->absorb_(m);
+      return false;
+    }
+    part.insert(it, std::move(m));
+    cur->buf->total++;
+    return true;
+  }
+
+  // sorted `batch`, newer than what `cur` holds, merged into its parts. returns how many keys were new there.
+  // a batch spreads over many parts, each likely out of cache, so all of them are fetched before any is merged.
+  static std::size_t put_batch_(node_type *cur, batch_type &batch) {
+    if (!cur->buf) cur->buf = new buffer_type{};
+    std::size_t child[M], end[M], runs{0};
+    for (auto first = batch.begin(); first != batch.end(); runs++) {
+      std::size_t i{cur->find_idx_ptr_index_(first->key)};
+      first = i < cur->key_cnt ? std::lower_bound(first, batch.end(), cur->key_at_(i), key_less_) : batch.end();
+      child[runs] = i;
+      end[runs] = static_cast<std::size_t>(first - batch.begin());
+      __builtin_prefetch(cur->buf->part + i);
+    }
+    for (std::size_t r = 0; r < runs; r++) {
+      const batch_type &part{cur->buf->part[child[r]]};
+      __builtin_prefetch(part.data() + part.size(), 1);
+    }
+    std::size_t added{0};
+    for (std::size_t r = 0; r < runs; r++) {
+      auto first{batch.begin() + static_cast<std::ptrdiff_t>(r > 0 ? end[r - 1] : 0)};
+      added += merge_part_(cur->buf->part[child[r]], first, batch.begin() + static_cast<std::ptrdiff_t>(end[r]));
+    }
+    cur->buf->total += added;
+    return added;
+  }
+
+  // sorted [first, last) into a part from the back. a key in both keeps one message, the newer on top. returns
+  // how many keys were new to the part.
+  static std::size_t merge_part_(batch_type &part, typename batch_type::iterator first,
+                                 typename batch_type::iterator last) {
+    std::size_t old{part.size()}, i{old}, w{old + static_cast<std::size_t>(last - first)};
+    bool repeated{false};
+    part.resize(w);
+    while (last != first) {
+      w--;
+      if (i > 0 && (last - 1)->key < part[i - 1].key) {
+        i--;
+        part[w] = std::move(part[i]);
+      } else {
+        repeated |= i > 0 && !(part[i - 1].key < (last - 1)->key);
+        --last;
+        part[w] = std::move(*last);
+      }
+    }
+    if (repeated) {
+      // the same key twice, side by side, the older in front.
+      std::size_t k{1};
+      for (std::size_t r = 1; r < part.size(); r++) {
+        if (!(part[k - 1].key < part[r].key)) {
+          part[k - 1].absorb_(part[r]);
+        } else {
+          if (k != r) part[k] = std::move(part[r]);
+          k++;
+        }
+      }
+      part.resize(k);
+    }
+    return part.size() - old;
+  }
+
+  // the messages for children [from, to] of `cur`, appended to `out` in key order and taken out.
+  static void take_parts_(node_type *cur, std::size_t from, std::size_t to, batch_type &out) {
+    if (!cur->buf) return;
+    for (std::size_t i = from; i <= to; i++) {
+      batch_type &part{cur->buf->part[i]};
+      cur->buf->total -= part.size();
+      out.insert(out.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+      part.clear();
+    }
+  }
+
+  // sorted messages [first, last) for children [from, to] of `cur`, moved into their parts, empty until now.
+  static void fill_parts_(node_type *cur, std::size_t from, std::size_t to, message_type *first, message_type *last) {
+    if (first == last) return;
+    if (!cur->buf) cur->buf = new buffer_type{};
+    cur->buf->total += static_cast<std::size_t>(last - first);
+    for (std::size_t j = from; j <= to; j++) {
+      message_type *stop{j < to ? std::lower_bound(first, last, cur->key_at_(j), key_less_) : last};
+      cur->buf->part[j].assign(std::make_move_iterator(first), std::make_move_iterator(stop));
+      first = stop;
+    }
+  }
+
+  // the same for the buffers of children [from, to] of `cur`, emptied until now.
+  static void fill_children_(node_type *cur, std::size_t from, std::size_t to, message_type *first,
+                             message_type *last) {
+    for (std::size_t j = from; j <= to && first != last; j++) {
+      message_type *stop{j < to ? std::lower_bound(first, last, cur->key_at_(j), key_less_) : last};
+      node_type *child{cur->idx.key_ptr[j]};
+      fill_parts_(child, 0, child->key_cnt, first, stop);
+      first = stop;
+    }
+  }
+
+  // all messages of `cur` in key order, its buffer freed.
+  static void take_all_(node_type *cur, batch_type &out) {
+    take_parts_(cur, 0, cur->key_cnt, out);
+    delete std::exchange(cur->buf, nullptr);
+  }
+
+  // `fn` reshapes children [i - 2, i + 2] of `cur`, as the fixes do. the messages for them, in the buffer of
+  // `cur` and in their own, go where the new separators send them.
+  template<typename fixer>
+  void refit_(node_type *cur, std::size_t i, fixer &&fn) {
+    std::size_t from{i >= 2 ? i - 2 : 0}, to{std::min(i + 2, cur->key_cnt)}, old{cur->key_cnt};
+    batch_type mine{}, theirs{};
+    take_parts_(cur, from, to, mine);
+    if (!cur->idx.key_ptr[i]->is_leaf) {
+      for (std::size_t j = from; j <= to; j++) {
+        take_all_(cur->idx.key_ptr[j], theirs);
+      }
+    }
+    fn();
+    if (cur->buf && cur->key_cnt != old) {
+      // the parts right of the window follow their children.
+      batch_type *part{cur->buf->part};
+      if (cur->key_cnt > old) {
+        std::move_backward(part + to + 1, part + old + 1, part + cur->key_cnt + 1);
+        std::for_each(part + to + 1, part + to + 1 + (cur->key_cnt - old), [](batch_type &p) { p.clear(); });
+      } else {
+        std::move(part + to + 1, part + old + 1, part + to + 1 - (old - cur->key_cnt));
+        std::for_each(part + cur->key_cnt + 1, part + old + 1, [](batch_type &p) { p.clear(); });
+      }
+    }
+    to = to + cur->key_cnt - old;
+    fill_parts_(cur, from, to, mine.data(), mine.data() + mine.size());
+    fill_children_(cur, from, to, theirs.data(), theirs.data() + theirs.size());
+  }
+
+  // the old root's messages go to the two halves it is split into.
+  void split_root_() {
+    batch_type moved{};
+    take_all_(root, moved);
+    this->fix_root_overflow_();
+    fill_children_(root, 0, 1, moved.data(), moved.data() + moved.size());
+  }
+
+  // the two children of the root fit in one node short of full, a batch may split a child right after.
+  bool root_merge_fits_() const noexcept {
+    const node_type *a{root->idx.key_ptr[0]}, *b{root->idx.key_ptr[1]};
+    return a->is_leaf ? a->key_cnt + b->key_cnt <= base::MAX_KEYS : a->key_cnt + b->key_cnt + 1 < base::MAX_KEYS;
+  }
+
+  // with `root_merge_fits_()`. the root's messages are newer than its children's, they go on top.
+  void merge_root_() {
+    batch_type older{}, newer{};
+    take_all_(root->idx.key_ptr[0], older);
+    take_all_(root->idx.key_ptr[1], older);
+    take_all_(root, newer);
+    this->fix_root_underflow_();
+    if (!root->is_leaf) {
+      fill_parts_(root, 0, root->key_cnt, older.data(), older.data() + older.size());
+      for (message_type &m : newer) {
+        pending_ -= !put_(root, std::move(m));
+      }
+    } else {
+      // a single leaf is left, nothing else holds a buffer.
+      for (const message_type &m : newer) {
+        apply_(m);
+      }
+      pending_ -= newer.size();
+    }
+  }
+
+  // through the plain tree, only while no buffer is left on the way.
+  void apply_(const message_type &m) {
+    if (m.op == b_op::INSERT) {
+      base::insert(m.key, m.val);
+    } else if (m.op == b_op::ASSIGN) {
+      base::insert_or_assign(m.key, m.val);
+    } else {
+      base::erase(m.key);
+    }
+  }
+
+  // as much of `batch` as the leaves under `cur` take, in order. stops at a leaf to split once `cur` is full,
+  // `cur` is fixed from its parent first. returns how many messages went in.
+  std::size_t apply_to_leaves_(node_type *cur, batch_type &batch) {
+    std::size_t done{0};
+    for (; done < batch.size(); done++) {
+      const message_type &m{batch[done]};
+      std::size_t i{cur->find_idx_ptr_index_(m.key)};
+      node_type *leaf{cur->idx.key_ptr[i]};
+      if (m.op != b_op::ERASE && this->is_overflow_(leaf)) {
+        if (this->is_overflow_(cur)) break;
+        if (!leaf->leaf.sib && leaf->key_at_(leaf->key_cnt - 1) < m.key) {
+          refit_(cur, i, [&]() { this->do_append_split_(leaf, cur, i); });
+        } else {
+          refit_(cur, i, [&]() { this->fix_overflow_(leaf, cur, i); });
+        }
+        leaf = cur->idx.key_ptr[cur->find_idx_ptr_index_(m.key)];
+      } else if (m.op == b_op::ERASE && this->is_underflow_(leaf)) {
+        refit_(cur, i, [&]() { this->fix_underflow_(leaf, cur, i); });
+        leaf = cur->idx.key_ptr[cur->find_idx_ptr_index_(m.key)];
+      }
+      if (m.op == b_op::ERASE) {
+        this->erase_leaf(leaf, m.key);
+      } else {
+        i = cur->find_idx_ptr_index_(m.key);
+        done = merge_leaf_(leaf, i < cur->key_cnt ? &cur->key_at_(i) : nullptr, batch, done) - 1;
+      }
+    }
+    return done;
+  }
+
+  // the puts of `batch` from `from` on that belong in `cur`, below `hi` unless null, as many as it has room
+  // for, merged in one pass from the back. returns where it stopped, past `from`: `cur` is not full.
+  static std::size_t merge_leaf_(node_type *cur, const key_type *hi, batch_type &batch, std::size_t from) noexcept {
+    std::size_t add_at[base::MAX_KEYS];
+    std::size_t room{base::MAX_KEYS - cur->key_cnt}, add{0}, li{cur->find_data_ptr_index_(batch[from].key)}, j{from};
+    for (; j < batch.size() && add < room; j++) {
+      const message_type &m{batch[j]};
+      if (m.op == b_op::ERASE || (hi && !(m.key < *hi))) break;
+      while (li < cur->key_cnt && cur->key_at_(li) < m.key) {
+        li++;
+      }
+      if (li < cur->key_cnt && !(m.key < cur->key_at_(li))) {
+        if (m.op == b_op::ASSIGN) cur->leaf.data[li] = m.val;
+        continue;
+      }
+      add_at[add++] = j;
+    }
+
+    std::size_t w{cur->key_cnt + add}, i{cur->key_cnt}, k{add};
+    while (k > 0) {
+      w--;
+      const message_type &m{batch[add_at[k - 1]]};
+      if (i > 0 && m.key < cur->key_at_(i - 1)) {
+        i--;
+        cur->move_keys_(w, i, 1);
+        cur->leaf.data[w] = cur->leaf.data[i];
+      } else {
+        k--;
+        cur->set_key_(w, m.key);
+        cur->leaf.data[w] = m.val;
+      }
+    }
+    count_(b_event::MOVED_BYTES, (cur->key_cnt - i) * base::ENTRY_BYTES);
+    cur->key_cnt += add;
+    return j;
+  }
+
+  static bool erases_(const batch_type &batch) noexcept {
+    return std::any_of(batch.begin(), batch.end(), [](const message_type &m) { return m.op == b_op::ERASE; });
+  }
+
+  // the child of `cur` with the most messages waiting. the buffer is not empty.
+  static std::size_t heaviest_(const node_type *cur) noexcept {
+    std::size_t best{0};
+    for (std::size_t i = 1; i <= cur->key_cnt; i++) {
+      if (cur->buf->part[i].size() > cur->buf->part[best].size()) best = i;
+    }
+    return best;
+  }
+
+  // one batch down per level from the root, on while the buffer it lands in is full. the batch may hold both
+  // inserts and erases: a full child is split first, as `insert()` would, the step ends once that fills its
+  // parent. a child at `low_water` is fixed once as `erase()` would when the batch erases, and takes the batch
+  // however that went.
+  void flush_step_() {
+    if (this->root_overflow_(root)) {
+      split_root_();
+    } else if (this->root_underflow_() && root_merge_fits_()) {
+      merge_root_();
+    }
+    node_type *cur{root};
+    bool fixed{false};
+    while (!cur->is_leaf && pending_in_(cur) > 0) {
+      std::size_t i{heaviest_(cur)};
+      node_type *child{cur->idx.key_ptr[i]};
+      if (child->is_leaf) {
+        count_(b_event::BUFFER_FLUSH);
+        batch_type batch{};
+        take_parts_(cur, i, i, batch);
+        std::size_t applied{apply_to_leaves_(cur, batch)};
+        pending_ -= applied;
+        // the rest waits where the split left it, no newer message has its keys.
+        batch.erase(batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(applied));
+        put_batch_(cur, batch);
+        return;
+      }
+      if (this->is_overflow_(child)) {
+        refit_(cur, i, [&]() { this->fix_overflow_(child, cur, i); });
+        if (this->is_overflow_(cur)) return;
+        continue;
+      }
+      if (this->is_underflow_(child) && !fixed && erases_(cur->buf->part[i])) {
+        refit_(cur, i, [&]() { this->fix_underflow_(child, cur, i); });
+        fixed = true;
+        continue;
+      }
+      count_(b_event::BUFFER_FLUSH);
+      batch_type batch{};
+      take_parts_(cur, i, i, batch);
+      pending_ -= batch.size() - put_batch_(child, batch);
+      if (pending_in_(child) < buffer_limit) return;
+      cur = child;
+      fixed = false;
+    }
+  }
+
+  void write_(const key_type &k, slot_type v, b_op op) {
+    if (!node_type::key_fits_(k)) return;
+    if (root->is_leaf) {
+      apply_({k, v, op});
+      return;
+    }
+    pending_ += put_(root, {k, v, op});
+    while (pending_in_(root) >= buffer_limit) {
+      flush_step_();
+    }
+  }
+
+public:
+  b_star_buffered_tree() = default;
+
+  template<std::forward_iterator iter>
+  b_star_buffered_tree(iter first, iter last, double fill_factor = 1.0) : base{first, last, fill_factor} {}
+
+  // a larger limit moves larger batches and leaves more in the buffers, at least 1. `M` is the default.
+  void set_buffer_limit(std::size_t messages) noexcept {
+    buffer_limit = std::max<std::size_t>(messages, 1);
+  }
+
+  // messages not in a leaf yet.
+  std::size_t pending() const noexcept {
+    return pending_;
+  }
+
+  void clear() {
+    base::clear();
+    pending_ = 0;
+  }
+
+  template<std::forward_iterator iter>
+  void bulk_load(iter first, iter last, double fill_factor = 1.0) {
+    base::bulk_load(first, last, fill_factor);
+    pending_ = 0;
+  }
+
+  template<std::random_access_iterator iter>
+  void bulk_load_parallel(iter first, iter last, std::size_t threads, double fill_factor = 1.0, bool sorted = false) {
+    base::bulk_load_parallel(first, last, threads, fill_factor, sorted);
+    pending_ = 0;
+  }
+
+  // `k` maps to `v` afterwards, unless it was there already.
+  void insert(const key_type &k, slot_type v) {
+    write_(k, v, b_op::INSERT);
+  }
+
+  // `k` maps to `v` afterwards.
+  void insert_or_assign(const key_type &k, slot_type v) {
+    write_(k, v, b_op::ASSIGN);
+  }
+
+  void erase(const key_type &k) {
+    write_(k, slot_type{}, b_op::ERASE);
+  }
+
+  // a value still in a buffer lives there until the message moves, as a leaf slot does until the leaf changes.
+  val_type *find_single(const key_type &k) const {
+    message_type *inserted{};
+    node_type *cur{root};
+    while (!cur->is_leaf) {
+      std::size_t i{cur->find_idx_ptr_index_(k)};
+      if (cur->buf) {
+        batch_type &part{cur->buf->part[i]};
+        auto it{std::lower_bound(part.begin(), part.end(), k, key_less_)};
+        if (it != part.end() && !(k < it->key)) {
+          // an `INSERT` counts only if no older message or leaf has the key, the oldest one wins.
+          if (it->op == b_op::ASSIGN) return message_val_(&*it);
+          if (it->op == b_op::ERASE) return inserted ? message_val_(inserted) : nullptr;
+          inserted = &*it;
+        }
+      }
+      cur = cur->idx.key_ptr[i];
+    }
+    val_type *val{this->find_collect_single(cur, k)};
+    return val || !inserted ? val : message_val_(inserted);
+  }
+
+  // every pending message into the leaves.
+  void flush() {
+    if (pending_ == 0) return;
+    // the deepest messages are the oldest.
+    std::vector<batch_type> levels{};
+    std::vector<std::pair<node_type *, std::size_t>> todo{{root, 0}};
+    while (!todo.empty()) {
+      auto [cur, depth]{todo.back()};
+      todo.pop_back();
+      if (cur->is_leaf) continue;
+      if (levels.size() <= depth) levels.resize(depth + 1);
+      take_all_(cur, levels[depth]);
+      for (std::size_t i = 0; i <= cur->key_cnt; i++) {
+        todo.emplace_back(cur->idx.key_ptr[i], depth + 1);
+      }
+    }
+    pending_ = 0;
+    for (auto level = levels.rbegin(); level != levels.rend(); ++level) {
+      for (const message_type &m : *level) {
+        apply_(m);
+      }
+    }
+  }
+
+  // these read the leaves, every pending message goes in first.
+  std::vector<val_type *> find_range(const key_type &low, const key_type &high) {
+    flush();
+    return base::find_range(low, high);
+  }
+
+  template<typename visitor>
+  std::size_t for_each_in_range(const key_type &low, const key_type &high, visitor &&fn) {
+    flush();
+    return base::for_each_in_range(low, high, std::forward<visitor>(fn));
+  }
+
+  template<typename acc_type, typename folder, typename merger>
+  acc_type reduce_range(const key_type &low, const key_type &high, acc_type init, folder &&fn, merger &&merge,
+                        std::size_t threads) {
+    flush();
+    return base::reduce_range(low, high, std::move(init), std::forward<folder>(fn), std::forward<merger>(merge),
+                              threads);
+  }
+
+  typename base::cursor begin() {
+    flush();
+    return base::begin();
+  }
+
+  typename base::cursor lower_bound(const key_type &k) {
+    flush();
+    return base::lower_bound(k);
+  }
+
+  typename base::cursor upper_bound(const key_type &k) {
+    flush();
+    return base::upper_bound(k);
+  }
+
+  bool save(const char *path) {
+    flush();
+    return base::save(path);
+  }
+
+  template<std::size_t B = b_frozen_width_<key_type>>
+  b_star_frozen<key_type, val_type, B> freeze() {
+    flush();
+    return base::template freeze<B>();
+  }
+
+  // these would go past the buffers.
+  template<std::random_access_iterator iter>
+  std::size_t insert_batch(iter first, iter last, bool sorted = false) = delete;
+  template<std::random_access_iterator iter>
+  std::size_t erase_batch(iter first, iter last, bool sorted = false) = delete;
+  std::size_t erase_range(const key_type &low, const key_type &high) = delete;
+  std::size_t find_many(const key_type *keys, std::size_t n, val_type **out) const = delete;
+  std::pair<val_type *, bool> try_emplace(const key_type &k, slot_type v) = delete;
+  template<typename updater>
+  bool update(const key_type &k, slot_type init, updater &&fn) = delete;
+  typename base::cursor insert_hint(typename base::cursor hint, const key_type &k, slot_type v) = delete;
+  void compact(double target_fill = 1.0) = delete;
+  bool compact_step(std::size_t max_parents = 1, double target_fill = 1.0) = delete;
+  void rebalance() = delete;
+};
@@ -0,0 +1,426 @@
+#pragma once
+#include "b_star_tree_refactored.h"
+
+/*================================================*\
+
+  Point-in-time snapshots, `b_star_cow_tree`.
+
+  `snapshot()` hands out the current root, O(1).
+  From then on a writer never changes a node the
+  snapshot can reach: it copies every node on its
+  way down that is older than the newest open
+  snapshot (path copying), and the siblings a fix
+  may touch, then works on the copies. Untouched
+  subtrees stay shared.
+
+  Every node is stamped with the write epoch it was
+  allocated in, a node is visible to the snapshots
+  taken between its epoch and the one it was freed
+  in, and is recycled once the last of them closes.
+
+  Snapshots read by descent, never through
+  `leaf.sib`: the live tree keeps its leaf chain,
+  so a copied leaf is linked in place of the
+  original, shared leaf before it included.
+
+\*================================================*/
+
+template<typename key_type, typename val_type, std::size_t M, typename slot_type = val_type *>
+struct b_cow_node
+    : public b_base_node<key_type, val_type, M, b_cow_node<key_type, val_type, M, slot_type>, slot_type> {
+  // the write epoch it was allocated in, see `b_cow_alloc`.
+  std::uint64_t version;
+};
+
+// Stamps nodes with the write epoch and defers `deallocate()` while an open snapshot can still read the node.
+// Snapshots may be opened and closed from any thread, allocations are serialized.
+template<typename node_type, typename inner_type = b_node_default_alloc<node_type>>
+class b_cow_alloc {
+  inner_type inner{};
+  mutable std::mutex mtx{};
+  // nodes allocated now carry it, a snapshot opened now reads the nodes up to it.
+  std::uint64_t epoch{1};
+  std::multiset<std::uint64_t> open{};
+  // the newest open snapshot, 0 for none.
+  std::atomic<std::uint64_t> newest{0};
+  // (version, freed in, node), held back for the snapshots in [version, freed in).
+  std::vector<std::tuple<std::uint64_t, std::uint64_t, node_type *>> retired{};
+
+  // `mtx` held.
+  bool seen_(std::uint64_t version, std::uint64_t freed) const noexcept {
+    auto it{open.lower_bound(version)};
+    return it != open.end() && *it < freed;
+  }
+
+public:
+  b_cow_alloc() = default;
+  b_cow_alloc(const b_cow_alloc &) = delete;
+  b_cow_alloc &operator=(const b_cow_alloc &) = delete;
+  ~b_cow_alloc() {
+    for (auto [v, e, n] : retired) {
+      inner.deallocate(n);
+    }
+  }
+
+  node_type *allocate() {
+    std::lock_guard<std::mutex> lock{mtx};
+    node_type *n{inner.allocate()};
+    n->version = epoch;
+    return n;
+  }
+
+  void deallocate(node_type *n) noexcept {
+    std::lock_guard<std::mutex> lock{mtx};
+    if (seen_(n->version, epoch)) {
+      retired.emplace_back(n->version, epoch, n);
+    } else {
+      inner.deallocate(n);
+    }
+  }
+
+  // an open snapshot may read `n`, a writer copies it first.
+  bool shared(const node_type *n) const noexcept {
+    return n->version <= newest.load(std::memory_order_acquire);
+  }
+
+  // the epoch of the new snapshot, what `close()` takes back.
+  std::uint64_t open_snapshot() {
+    std::lock_guard<std::mutex> lock{mtx};
+    std::uint64_t s{epoch++};
+    open.insert(s);
+    newest.store(s, std::memory_order_release);
+    return s;
+  }
+
+  void close_snapshot(std::uint64_t s) noexcept {
+    std::lock_guard<std::mutex> lock{mtx};
+    open.erase(open.find(s));
+    newest.store(open.empty() ? 0 : *open.rbegin(), std::memory_order_release);
+    std::size_t kept{};
+    for (auto [v, e, n] : retired) {
+      if (seen_(v, e)) {
+        retired[kept++] = {v, e, n};
+      } else {
+        inner.deallocate(n);
+      }
+    }
+    retired.resize(kept);
+  }
+
+  // nodes held back for open snapshots.
+  std::size_t retired_nodes() const noexcept {
+    std::lock_guard<std::mutex> lock{mtx};
+    return retired.size();
+  }
+};
+
+// One writer, or writers serialized by the caller, as for `b_star_tree`; `snapshot()` is a write in that sense.
+// A `view` reads from any thread while the writer goes on, it must be closed before the tree is destroyed.
+// With `val_type *` slots only the pointers are snapshotted, `b_cow_node<K, V, M, V>` keeps the values:
+// reads hand out `const val_type *`, since a leaf may be shared, and values change only through a write,
+// `insert_or_assign()` or `update()`, which copies the path first.
+template<typename key_type, typename val_type, std::size_t M, typename node_type = b_cow_node<key_type, val_type, M>,
+         typename alloc_type = b_cow_alloc<node_type>, typename stats_type = b_no_stats>
+class b_star_cow_tree : public b_star_tree<key_type, val_type, M, node_type, alloc_type, stats_type> {
+protected:
+  using base = b_star_tree<key_type, val_type, M, node_type, alloc_type, stats_type>;
+  using typename base::key_ref;
+  using typename base::slot_type;
+  using base::alloc;
+  using base::count_;
+  using base::root;
+
+  static node_type *rightmost_(node_type *cur) noexcept {
+    while (!cur->is_leaf) {
+      cur = cur->idx.key_ptr[cur->key_cnt];
+    }
+    return cur;
+  }
+
+  // `cur` itself when no snapshot reads it, otherwise a copy that replaces it under `parent` (or as the root).
+  // a copied leaf is linked after `pred`, the leaf before it in the live tree.
+  node_type *own_(node_type *cur, node_type *parent, std::size_t i, node_type *pred) {
+    if (!alloc.shared(cur)) return cur;
+    count_(b_event::NODE_COPY);
+    node_type *copy{this->new_node_(cur->is_leaf)};
+    std::uint64_t version{copy->version};
+    *copy = *cur;
+    copy->version = version;
+    if (cur->is_leaf && pred) pred->leaf.sib = copy;
+    if (parent) {
+      parent->idx.key_ptr[i] = copy;
+    } else {
+      root = copy;
+    }
+    this->delete_node_(cur);
+    return copy;
+  }
+
+  // children [from, to] of `parent`, left to right. `left` is the subtree left of `parent`, if any.
+  void own_children_(node_type *parent, std::size_t from, std::size_t to, node_type *left) {
+    for (std::size_t i = from; i <= to; i++) {
+      node_type *cur{parent->idx.key_ptr[i]};
+      if (!alloc.shared(cur)) continue;
+      node_type *pred{!cur->is_leaf ? nullptr : i > 0 ? parent->idx.key_ptr[i - 1] : left ? rightmost_(left) : nullptr};
+      own_(cur, parent, i, pred);
+    }
+  }
+
+  // as `insert_down_to_leaf()` / `erase_down_to_leaf()`, on a path no snapshot reads. every fix
+  // gets the children it may touch, [idx - 2, idx + 2], copied first.
+  node_type *write_down_to_leaf_(const key_type &k, bool inserting) {
+    own_(root, nullptr, 0, nullptr);
+    if (inserting && this->root_overflow_(root)) {
+      this->fix_root_overflow_();
+    } else if (!inserting && this->root_underflow_()) {
+      own_children_(root, 0, 1, nullptr);
+      this->fix_root_underflow_();
+    }
+    node_type *cur{root}, *left{};
+    count_(b_event::DESCENTS);
+    while (!cur->is_leaf) {
+      count_(b_event::DESCENT_LEVELS);
+      std::size_t next_from{cur->find_idx_ptr_index_(k)};
+      node_type *next{cur->idx.key_ptr[next_from]};
+      if (inserting ? this->is_overflow_(next) : this->is_underflow_(next)) {
+        own_children_(cur, next_from >= 2 ? next_from - 2 : 0, std::min(next_from + 2, cur->key_cnt), left);
+        next = cur->idx.key_ptr[next_from];
+        if (!inserting) {
+          this->fix_underflow_(next, cur, next_from);
+        } else if (next->is_leaf && !next->leaf.sib && next->key_at_(next->key_cnt - 1) < k) {
+          this->do_append_split_(next, cur, next_from);
+        } else {
+          this->fix_overflow_(next, cur, next_from);
+        }
+        next_from = cur->find_idx_ptr_index_(k);
+      } else {
+        own_children_(cur, next_from, next_from, left);
+      }
+      if (next_from > 0) left = cur->idx.key_ptr[next_from - 1];
+      cur = cur->idx.key_ptr[next_from];
+    }
+    return cur;
+  }
+
+public:
+  // as `b_star_tree::cursor`, with read-only values.
+  class cursor : public base::cursor {
+  public:
+    using value_type = std::pair<key_ref, const val_type *>;
+    using reference = value_type;
+
+    cursor() = default;
+    cursor(typename base::cursor it) noexcept : base::cursor{it} {}
+
+    const val_type *value() const noexcept {
+      return base::cursor::value();
+    }
+    reference operator*() const noexcept {
+      return {this->key(), value()};
+    }
+
+    cursor &operator++() noexcept {
+      base::cursor::operator++();
+      return *this;
+    }
+    cursor operator++(int) noexcept {
+      cursor old{*this};
+      ++*this;
+      return old;
+    }
+  };
+
+  // a point-in-time, read-only copy of the tree sharing its nodes. closes itself.
+  class view {
+    alloc_type *alloc{};
+    node_type *root{};
+    std::uint64_t epoch{};
+
+    // [low, high) under `cur`, a null bound leaves that side open. false once `fn` asked to stop.
+    template<typename visitor>
+    static bool visit_(node_type *cur, const key_type *low, const key_type *high, visitor &fn, std::size_t &visited) {
+      std::size_t from{low ? cur->find_data_ptr_index_(*low) : 0};
+      std::size_t to{high ? cur->find_data_ptr_index_(*high) : cur->key_cnt};
+      if (cur->is_leaf) {
+        for (std::size_t i = from; i < to; i++) {
+          visited++;
+          const val_type *v{cur->val_ptr_(i)};
+          if constexpr (std::is_same_v<std::invoke_result_t<visitor &, key_ref, const val_type *>, bool>) {
+            if (!fn(cur->key_at_(i), v)) return false;
+          } else {
+            fn(cur->key_at_(i), v);
+          }
+        }
+        return true;
+      }
+      for (std::size_t i = from; i <= to; i++) {
+        if (!visit_(cur->idx.key_ptr[i], i == from ? low : nullptr, i == to ? high : nullptr, fn, visited)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+  public:
+    view() = default;
+    view(alloc_type *alloc, node_type *root, std::uint64_t epoch) noexcept : alloc{alloc}, root{root}, epoch{epoch} {}
+    view(view &&obj) noexcept : alloc{std::exchange(obj.alloc, nullptr)}, root{obj.root}, epoch{obj.epoch} {}
+    view &operator=(view &&obj) noexcept {
+      if (this != &obj) {
+        close();
+        alloc = std::exchange(obj.alloc, nullptr);
+        root = obj.root;
+        epoch = obj.epoch;
+      }
+      return *this;
+    }
+    ~view() {
+      close();
+    }
+
+    // lets the writer recycle what only this snapshot still read.
+    void close() noexcept {
+      if (alloc) std::exchange(alloc, nullptr)->close_snapshot(epoch);
+    }
+
+    bool is_open() const noexcept {
+      return alloc;
+    }
+
+    const val_type *find_single(const key_type &k) const {
+      node_type *cur{root};
+      while (!cur->is_leaf) {
+        cur = cur->idx.key_ptr[cur->find_idx_ptr_index_(k)];
+      }
+      std::size_t i{cur->find_data_ptr_index_(k)};
+      return i < cur->key_cnt && !(k < cur->key_at_(i)) ? cur->val_ptr_(i) : nullptr;
+    }
+
+    // as `b_star_tree::for_each_in_range()`.
+    template<typename visitor>
+    std::size_t for_each_in_range(const key_type &low, const key_type &high, visitor &&fn) const {
+      std::size_t visited{};
+      if (low < high) visit_(root, &low, &high, fn, visited);
+      return visited;
+    }
+
+    // every entry in key order.
+    template<typename visitor>
+    std::size_t for_each(visitor &&fn) const {
+      std::size_t visited{};
+      visit_(root, nullptr, nullptr, fn, visited);
+      return visited;
+    }
+  };
+
+  b_star_cow_tree() {
+    // the last leaf may be shared, inserts always descend.
+    this->track_tail = false;
+  }
+
+  template<std::forward_iterator iter>
+  b_star_cow_tree(iter first, iter last, double fill_factor = 1.0) : b_star_cow_tree{} {
+    this->bulk_load(first, last, fill_factor);
+  }
+
+  // O(1), the tree as it is now until the view closes.
+  view snapshot() {
+    return view{&alloc, root, alloc.open_snapshot()};
+  }
+
+  // nodes the writer dropped that an open snapshot still reads.
+  std::size_t retired_nodes() const noexcept {
+    return alloc.retired_nodes();
+  }
+
+  // the reads of `b_star_tree`, handing out `const val_type *`.
+
+  const val_type *find_single(const key_type &k) const {
+    return base::find_single(k);
+  }
+
+  std::size_t find_many(const key_type *keys, std::size_t n, const val_type **out) const {
+    return base::find_many(keys, n, const_cast<val_type **>(out));
+  }
+
+  std::vector<const val_type *> find_range(const key_type &low, const key_type &high) const {
+    std::vector<const val_type *> vals{};
+    for_each_in_range(low, high, [&](key_ref, const val_type *v) { vals.emplace_back(v); });
+    return vals;
+  }
+
+  template<typename visitor>
+  std::size_t for_each_in_range(const key_type &low, const key_type &high, visitor &&fn) const {
+    return base::for_each_in_range(low, high, [&fn](key_ref k, val_type *v) -> decltype(auto) {
+      return fn(k, static_cast<const val_type *>(v));
+    });
+  }
+
+  template<typename acc_type, typename folder, typename merger>
+  acc_type reduce_range(const key_type &low, const key_type &high, acc_type init, folder &&fn, merger &&merge,
+                        std::size_t threads) const {
+    return base::reduce_range(
+        low, high, std::move(init),
+        [&fn](acc_type &acc, key_ref k, val_type *v) { fn(acc, k, static_cast<const val_type *>(v)); }, merge, threads);
+  }
+
+  cursor begin() const noexcept {
+    return base::begin();
+  }
+
+  cursor end() const noexcept {
+    return base::end();
+  }
+
+  cursor lower_bound(const key_type &k) const {
+    return base::lower_bound(k);
+  }
+
+  cursor upper_bound(const key_type &k) const {
+    return base::upper_bound(k);
+  }
+
+  bool insert(const key_type &k, slot_type v) {
+    if (!node_type::key_fits_(k)) return false;
+    return this->insert_leaf(write_down_to_leaf_(k, true), k, v);
+  }
+
+  bool erase(const key_type &k) {
+    return this->erase_leaf(write_down_to_leaf_(k, false), k);
+  }
+
+  // the value in a leaf no snapshot reads, writable until the next write, `snapshot()` included.
+  std::pair<val_type *, bool> try_emplace(const key_type &k, slot_type v) {
+    if (!node_type::key_fits_(k)) return {nullptr, false};
+    node_type *cur{write_down_to_leaf_(k, true)};
+    auto [idx, inserted]{this->emplace_leaf_(cur, k, v)};
+    return {cur->val_ptr_(idx), inserted};
+  }
+
+  bool insert_or_assign(const key_type &k, slot_type v) {
+    if (!node_type::key_fits_(k)) return false;
+    node_type *cur{write_down_to_leaf_(k, true)};
+    auto [idx, inserted]{this->emplace_leaf_(cur, k, v)};
+    if (!inserted) cur->leaf.data[idx] = v;
+    return inserted;
+  }
+
+  template<typename updater>
+  bool update(const key_type &k, slot_type init, updater &&fn) {
+    if (!node_type::key_fits_(k)) return false;
+    node_type *cur{write_down_to_leaf_(k, true)};
+    auto [idx, inserted]{this->emplace_leaf_(cur, k, init)};
+    fn(cur->val_ptr_(idx));
+    return !inserted;
+  }
+
+  // these write nodes in place past a single path.
+  template<std::random_access_iterator iter>
+  std::size_t insert_batch(iter first, iter last, bool sorted = false) = delete;
+  template<std::random_access_iterator iter>
+  std::size_t erase_batch(iter first, iter last, bool sorted = false) = delete;
+  std::size_t erase_range(const key_type &low, const key_type &high) = delete;
+  cursor insert_hint(cursor hint, const key_type &k, slot_type v) = delete;
+  bool compact_step(std::size_t max_parents = 1, double target_fill = 1.0) = delete;
+  void rebalance() = delete;
+};
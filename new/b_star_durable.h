@@ -0,0 +1,252 @@
+#pragma once
+#include "b_star_tree_refactored.h"
+
+/*================================================*\
+
+  Durable B*-tree, a write-ahead log.
+
+  Every `insert()` / `erase()` that changes the
+  tree appends a record, and returns once the
+  record is on disk. A flusher thread writes
+  whatever records piled up with one `write()`
+  and one `fdatasync()` (group commit).
+
+  `checkpoint()` saves the tree as an image next
+  to the log, `path + ".ckpt"`, and empties the log.
+  `open()` bulk loads the image, then replays the
+  log on top of it.
+
+\*================================================*/
+
+struct b_wal_options {
+  // how long the flusher lets a group grow after its first record.
+  std::chrono::microseconds commit_window{200};
+  // a group this large is flushed without waiting out the window.
+  std::size_t batch_bytes{std::size_t{1} << 16};
+};
+
+template<typename key_type, typename val_type>
+struct b_wal_record {
+  static constexpr std::uint32_t INSERT = 1;
+  static constexpr std::uint32_t ERASE = 2;
+
+  std::uint32_t op;
+  // FNV-1a over `op`, `key` and `val` one by one, a torn tail fails it. the padding between them is left out,
+  // it holds whatever a copy of the record leaves there.
+  std::uint32_t sum;
+  key_type key;
+  val_type val;
+
+  std::uint32_t checksum_() const noexcept {
+    std::uint32_t h{2166136261u};
+    auto mix = [&h](const void *field, std::size_t n) {
+      const unsigned char *p{static_cast<const unsigned char *>(field)};
+      for (std::size_t i = 0; i < n; i++) {
+        h = (h ^ p[i]) * 16777619u;
+      }
+    };
+    mix(&op, sizeof(op));
+    mix(&key, sizeof(key));
+    mix(&val, sizeof(val));
+    return h;
+  }
+};
+
+template<typename key_type, typename val_type, std::size_t M,
+         typename tree_type = b_star_tree<key_type, val_type, M, b_star_inline_node<key_type, val_type, M>>>
+class b_star_durable {
+protected:
+  using record = b_wal_record<key_type, val_type>;
+
+  static_assert(std::is_trivially_copyable_v<key_type> && std::is_trivially_copyable_v<val_type>,
+                "records store keys and values by value");
+
+  tree_type tree{};
+  b_wal_options opt{};
+  std::string log_path{}, ckpt_path{};
+  int fd{-1};
+
+  // guards everything below and the tree.
+  mutable std::mutex mtx{};
+  std::condition_variable work{}, done{};
+  std::string pending{};
+  std::uint64_t appended{0}, durable{0}, syncs{0};
+  bool stop{false};
+  std::thread flusher{};
+
+  // a log that failed to reach the disk cannot back any later commit.
+  static void write_all_(int fd, const char *p, std::size_t n) {
+    while (n > 0) {
+      ssize_t w{::write(fd, p, n)};
+      if (w < 0 && errno == EINTR) continue;
+      if (w <= 0) {
+        std::perror("b_star_durable: write");
+        std::abort();
+      }
+      p += w;
+      n -= static_cast<std::size_t>(w);
+    }
+    if (::fdatasync(fd) != 0) {
+      std::perror("b_star_durable: fdatasync");
+      std::abort();
+    }
+  }
+
+  void flush_loop_() {
+    std::string out{};
+    std::unique_lock<std::mutex> lk{mtx};
+    while (true) {
+      work.wait(lk, [&] { return stop || !pending.empty(); });
+      if (pending.empty()) return;
+      // let the group grow.
+      work.wait_for(lk, opt.commit_window, [&] { return stop || pending.size() >= opt.batch_bytes; });
+      out.swap(pending);
+      std::uint64_t upto{appended};
+      lk.unlock();
+      write_all_(fd, out.data(), out.size());
+      out.clear();
+      lk.lock();
+      durable = upto;
+      syncs++;
+      done.notify_all();
+    }
+  }
+
+  // with `mtx` held, returns once the record is on disk.
+  void commit_(std::unique_lock<std::mutex> &lk, std::uint32_t op, const key_type &k, const val_type &v) {
+    record r;
+    std::memset(&r, 0, sizeof(r));
+    r.op = op;
+    r.key = k;
+    r.val = v;
+    r.sum = r.checksum_();
+    bool first{pending.empty()};
+    pending.append(reinterpret_cast<const char *>(&r), sizeof(r));
+    std::uint64_t lsn{++appended};
+    if (first || pending.size() >= opt.batch_bytes) work.notify_one();
+    done.wait(lk, [&] { return durable >= lsn; });
+  }
+
+  // the longest prefix of whole, intact records is applied, anything after it is cut off.
+  bool replay_() {
+    std::vector<char> buf{};
+    char chunk[1 << 16];
+    ssize_t r{};
+    while ((r = ::read(fd, chunk, sizeof(chunk))) > 0) {
+      buf.insert(buf.end(), chunk, chunk + r);
+    }
+    if (r < 0) return false;
+
+    std::size_t good{0};
+    for (; good + sizeof(record) <= buf.size(); good += sizeof(record)) {
+      record rec;
+      std::memcpy(&rec, buf.data() + good, sizeof(rec));
+      if (rec.sum != rec.checksum_()) break;
+      if (rec.op == record::INSERT) {
+        tree.insert(rec.key, rec.val);
+      } else if (rec.op == record::ERASE) {
+        tree.erase(rec.key);
+      } else {
+        break;
+      }
+    }
+    return good == buf.size() || (::ftruncate(fd, static_cast<off_t>(good)) == 0 && ::fdatasync(fd) == 0);
+  }
+
+  // only changes are logged, and an insert never overwrites, so replaying records the checkpoint
+  // already holds leaves it as it is: a log that outlived its checkpoint, or was emptied late, is harmless.
+  bool load_checkpoint_() {
+    b_star_mapped<key_type, val_type, M> img{};
+    if (!img.open_mapped(ckpt_path.c_str())) return ::access(ckpt_path.c_str(), F_OK) != 0;
+    std::vector<std::pair<key_type, val_type>> items{};
+    items.reserve(img.size());
+    if (!img.for_each([&](const key_type &k, const val_type *v) { items.emplace_back(k, *v); }) ||
+        items.size() != img.size()) {
+      return false;
+    }
+    tree.bulk_load(items.begin(), items.end());
+    return true;
+  }
+
+  void close_() {
+    if (flusher.joinable()) {
+      {
+        std::lock_guard<std::mutex> lk{mtx};
+        stop = true;
+      }
+      work.notify_one();
+      flusher.join();
+    }
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    stop = false;
+  }
+
+public:
+  b_star_durable() = default;
+  b_star_durable(const b_star_durable &) = delete;
+  b_star_durable &operator=(const b_star_durable &) = delete;
+  ~b_star_durable() {
+    close_();
+  }
+
+  // loads `path + ".ckpt"` if there is one, replays the log at `path` and keeps appending to it.
+  bool open(const char *path, b_wal_options options = {}) {
+    close_();
+    opt = options;
+    log_path = path;
+    ckpt_path = log_path + ".ckpt";
+    tree.clear();
+    appended = durable = syncs = 0;
+    if (!load_checkpoint_()) return false;
+    fd = ::open(path, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) return false;
+    if (!replay_()) {
+      close_();
+      return false;
+    }
+    flusher = std::thread{[this] { flush_loop_(); }};
+    return true;
+  }
+
+  // the change is visible to `find_single()` before it is durable, the call returns once it is.
+  bool insert(const key_type &k, const val_type &v) {
+    std::unique_lock<std::mutex> lk{mtx};
+    if (!tree.insert(k, v)) return false;
+    commit_(lk, record::INSERT, k, v);
+    return true;
+  }
+
+  bool erase(const key_type &k) {
+    std::unique_lock<std::mutex> lk{mtx};
+    if (!tree.erase(k)) return false;
+    commit_(lk, record::ERASE, k, val_type{});
+    return true;
+  }
+
+  std::optional<val_type> find_single(const key_type &k) const {
+    std::lock_guard<std::mutex> lk{mtx};
+    const val_type *v{tree.find_single(k)};
+    return v ? std::optional<val_type>{*v} : std::nullopt;
+  }
+
+  // writers wait while the image is written.
+  // records still in flight are in the image too, wherever their write lands around the truncation.
+  bool checkpoint() {
+    std::lock_guard<std::mutex> lk{mtx};
+    if (!tree.save(ckpt_path.c_str())) return false;
+    // the rename has to reach the disk before the log is emptied.
+    std::string dir{std::filesystem::path{ckpt_path}.parent_path().string()};
+    int dfd{::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY)};
+    if (dfd < 0) return false;
+    bool ok{::fsync(dfd) == 0};
+    ::close(dfd);
+    return ok && ::ftruncate(fd, 0) == 0 && ::fdatasync(fd) == 0;
+  }
+
+  // `fdatasync()` calls so far, commits over syncs is the average group size.
+  std::uint64_t syncs_done() const {
+    std::lock_guard<std::mutex> lk{mtx};
+    return syncs;
+  }
+};
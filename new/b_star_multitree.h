@@ -0,0 +1,180 @@
+#pragma once
+#include "b_star_tree_refactored.h"
+
+/*================================================*\
+
+  Duplicated keys, `b_star_multitree`.
+
+  Equal keys sit next to each other in insertion
+  order, a run of them may go on over several
+  leaves. A separator is then no longer above every
+  key on its left, only `left <= separator <= right`:
+
+  - `insert()` goes right of every separator equal
+    to the key and lands after the run,
+  - lookups go left of them and may start one leaf
+    early, the run begins first in the next leaf,
+  - erasing goes left of them unless the subtree
+    there ends below the key, so the descent that
+    fixes the underflows is the one reaching it.
+
+\*================================================*/
+
+template<typename key_type, typename val_type, std::size_t M, typename node_type = b_star_node<key_type, val_type, M>,
+         typename alloc_type = b_node_default_alloc<node_type>, typename stats_type = b_no_stats>
+class b_star_multitree : public b_star_tree<key_type, val_type, M, node_type, alloc_type, stats_type> {
+protected:
+  using base = b_star_tree<key_type, val_type, M, node_type, alloc_type, stats_type>;
+  using typename base::slot_type;
+  using base::count_;
+  using base::ENTRY_BYTES;
+  using base::low_water;
+  using base::erase_leaf_run_;
+  using base::root;
+
+  // the largest key under `cur`.
+  static typename base::key_ref last_key_(const node_type *cur) noexcept {
+    while (!cur->is_leaf) {
+      cur = cur->idx.key_ptr[cur->key_cnt];
+    }
+    return cur->key_at_(cur->key_cnt - 1);
+  }
+
+  // the leftmost child holding `k`, past a separator equal to `k` only when the subtree left of it ends below `k`.
+  static std::size_t first_child_(node_type *cur, const key_type &k) noexcept {
+    std::size_t i{cur->find_data_ptr_index_(k)};
+    while (i < cur->key_cnt && !(k < cur->key_at_(i)) && last_key_(cur->idx.key_ptr[i]) < k) {
+      i++;
+    }
+    return i;
+  }
+
+  // as `erase_down_to_leaf()`, to the leaf holding the first `k` if there is one.
+  node_type *erase_first_down_to_leaf_(const key_type &k) noexcept {
+    if (this->root_underflow_()) {
+      this->fix_root_underflow_();
+    }
+    node_type *cur{root};
+    count_(b_event::DESCENTS);
+    while (!cur->is_leaf) {
+      count_(b_event::DESCENT_LEVELS);
+      std::size_t next_from{first_child_(cur, k)};
+      node_type *next{cur->idx.key_ptr[next_from]};
+      if (this->is_underflow_(next)) {
+        this->fix_underflow_(next, cur, next_from);
+        next_from = first_child_(cur, k);
+      }
+      cur = cur->idx.key_ptr[next_from];
+    }
+    return cur;
+  }
+
+public:
+  using typename base::cursor;
+
+  b_star_multitree() = default;
+
+  template<std::forward_iterator iter>
+  b_star_multitree(iter first, iter last, double fill_factor = 1.0) {
+    bulk_load(first, last, fill_factor);
+  }
+
+  // as `b_star_tree::bulk_load()`, keeping every duplicate in input order.
+  template<std::forward_iterator iter>
+  void bulk_load(iter first, iter last, double fill_factor = 1.0) {
+    this->delete_all_nodes_();
+    std::size_t n{0};
+    for (iter it = first; it != last; ++it) {
+      n += node_type::key_fits_(std::get<0>(*it));
+    }
+    if (n == 0) {
+      root = this->new_node_(true);
+      return;
+    }
+    this->build_from_sorted_(first, last, n, fill_factor, false);
+  }
+
+  // as `b_star_tree::bulk_load_parallel()`, keeping every duplicate in input order.
+  template<std::random_access_iterator iter>
+  void bulk_load_parallel(iter first, iter last, std::size_t threads, double fill_factor = 1.0, bool sorted = false) {
+    this->build_parallel_(first, last, threads, fill_factor, sorted, false);
+  }
+
+  // after the keys equal to `k` already there, false only for a key the node cannot store.
+  bool insert(const key_type &k, slot_type v) noexcept {
+    if (!node_type::key_fits_(k)) return false;
+    if (this->root_overflow_(root)) {
+      this->fix_root_overflow_();
+    }
+    node_type *cur{this->insert_down_to_leaf(root, k)};
+    std::size_t idx{cur->find_idx_ptr_index_(k)};
+    if (idx != cur->key_cnt) {
+      count_(b_event::MOVED_BYTES, (cur->key_cnt - idx) * ENTRY_BYTES);
+      std::memmove(cur->leaf.data + idx + 1, cur->leaf.data + idx, (cur->key_cnt - idx) * sizeof(slot_type));
+      cur->move_keys_(idx + 1, idx, cur->key_cnt - idx);
+    }
+    cur->leaf.data[idx] = v;
+    cur->set_key_(idx, k);
+    cur->key_cnt++;
+    return true;
+  }
+
+  // the first `k` inserted of those still there.
+  bool erase_one(const key_type &k) noexcept {
+    node_type *cur{erase_first_down_to_leaf_(k)};
+    std::size_t idx{cur->find_data_ptr_index_(k)};
+    if (idx == cur->key_cnt || k < cur->key_at_(idx)) return false;
+    erase_leaf_run_(cur, idx, idx + 1);
+    return true;
+  }
+
+  // every `k`, as much of the run as a leaf can give per descent. returns how many were erased.
+  std::size_t erase_all(const key_type &k) noexcept {
+    std::size_t erased{0};
+    while (true) {
+      node_type *cur{erase_first_down_to_leaf_(k)};
+      std::size_t budget{cur == root ? cur->key_cnt : std::max<std::size_t>(cur->key_cnt, low_water + 1) - low_water};
+      std::size_t from{cur->find_data_ptr_index_(k)}, to{from};
+      while (to < cur->key_cnt && to - from < budget && !(k < cur->key_at_(to))) {
+        to++;
+      }
+      if (to == from) return erased;
+      erase_leaf_run_(cur, from, to);
+      erased += to - from;
+      // the run ends inside this leaf.
+      if (from < cur->key_cnt && k < cur->key_at_(from)) return erased;
+    }
+  }
+
+  // the first `k`.
+  val_type *find_single(const key_type &k) const {
+    cursor it{this->lower_bound(k)};
+    return it != this->end() && !(k < it.key()) ? it.value() : nullptr;
+  }
+
+  // [first `k`, past the last `k`), in insertion order.
+  std::pair<cursor, cursor> equal_range(const key_type &k) const {
+    return {this->lower_bound(k), this->upper_bound(k)};
+  }
+
+  std::size_t count(const key_type &k) const {
+    std::size_t n{0};
+    for (cursor it{this->lower_bound(k)}; it != this->end() && !(k < it.key()); ++it) {
+      n++;
+    }
+    return n;
+  }
+
+  // these assume unique keys.
+  bool erase(const key_type &k) = delete;
+  template<std::random_access_iterator iter>
+  std::size_t insert_batch(iter first, iter last, bool sorted = false) = delete;
+  template<std::random_access_iterator iter>
+  std::size_t erase_batch(iter first, iter last, bool sorted = false) = delete;
+  std::size_t find_many(const key_type *keys, std::size_t n, val_type **out) const = delete;
+  std::pair<val_type *, bool> try_emplace(const key_type &k, slot_type v) = delete;
+  bool insert_or_assign(const key_type &k, slot_type v) = delete;
+  template<typename updater>
+  bool update(const key_type &k, slot_type init, updater &&fn) = delete;
+  cursor insert_hint(cursor hint, const key_type &k, slot_type v) = delete;
+};
@@ -0,0 +1,339 @@
+#pragma once
+#include "b_star_tree_refactored.h"
+
+/*================================================*\
+
+  String keys in a slotted node,
+  `b_star_tree<std::string, V, M, b_star_string_node<V, M>>`.
+
+  Key bytes live in a heap at the end of the node,
+  `off[i]` / `len[i]` locate key `i` in it.
+  Search compares bytes inside the node only,
+  no pointer is followed per comparison.
+
+  Every node strips the prefix its keys share
+  and keeps it once (prefix truncation),
+  leaf separators are cut to the shortest prefix
+  that still splits the two leaves (suffix truncation).
+
+  The heap is a byte budget, `HEAP_BYTES`. A node
+  reports itself full once its live bytes come close
+  to it, so the tree splits it like one holding
+  `M - 1` keys. Keys of any length are taken: when a
+  redistribution by key count or a few long keys
+  hand a node more bytes than its heap holds, they
+  go to a `spill` buffer on the side until they fit
+  again.
+
+\*================================================*/
+
+// a stored key, the node prefix plus its own suffix.
+struct b_split_key {
+  std::string_view pre, suf;
+
+  std::size_t size() const noexcept {
+    return pre.size() + suf.size();
+  }
+
+  operator std::string() const {
+    std::string s{};
+    s.reserve(size());
+    s.append(pre).append(suf);
+    return s;
+  }
+
+  friend bool operator==(const b_split_key &a, std::string_view b) noexcept {
+    return a.size() == b.size() && b.starts_with(a.pre) && b.substr(a.pre.size()) == a.suf;
+  }
+
+  friend std::strong_ordering operator<=>(const b_split_key &a, std::string_view b) noexcept {
+    std::size_t n{std::min(a.pre.size(), b.size())};
+    if (int c{a.pre.substr(0, n).compare(b.substr(0, n))}; c != 0) return c <=> 0;
+    // `b` ends inside the prefix.
+    if (n < a.pre.size()) return std::strong_ordering::greater;
+    return a.suf.compare(b.substr(n)) <=> 0;
+  }
+
+  // keys of two nodes, split at different places.
+  friend bool operator==(const b_split_key &a, const b_split_key &b) noexcept {
+    return a.size() == b.size() && (a <=> b) == 0;
+  }
+
+  friend std::strong_ordering operator<=>(const b_split_key &a, const b_split_key &b) noexcept {
+    if (a.pre.size() > b.pre.size()) return 0 <=> (b <=> a);
+    std::size_t n{a.pre.size()};
+    if (int c{a.pre.compare(b.pre.substr(0, n))}; c != 0) return c <=> 0;
+    return 0 <=> (b_split_key{b.pre.substr(n), b.suf} <=> a.suf);
+  }
+};
+
+template<typename val_type, std::size_t M, std::size_t HEAP_BYTES = 32 * (M - 1), typename slot_type = val_type *>
+struct b_star_string_node {
+
+  using key_t = std::string;
+  using val_t = val_type;
+  using slot_t = slot_type;
+  using len_t = std::uint32_t;
+
+  static constexpr bool INLINE_VAL = std::is_same_v<slot_type, val_type>;
+  static constexpr bool AUGMENTED = false;
+  static_assert(INLINE_VAL || std::is_same_v<slot_type, val_type *>);
+  static_assert(std::is_trivially_copyable_v<slot_type>, "slots are moved with memmove");
+  static_assert(HEAP_BYTES >= 64 && HEAP_BYTES <= std::numeric_limits<len_t>::max());
+
+  std::size_t key_cnt;
+  bool is_leaf;
+  // `top` is the first free heap byte, the heap is rebuilt once it passes `soft`.
+  // `live` counts the prefix and the bytes of the used slots, the garbage left out.
+  len_t pre_off{}, pre_len{}, top{}, soft{HEAP_BYTES / 2}, live{};
+  len_t off[M - 1];
+  len_t len[M - 1];
+  // slots holding bytes in the heap, a slot past `key_cnt` may still be in flight during a redistribution.
+  std::bitset<M - 1> used{};
+  union {
+    struct {
+      slot_type data[M - 1];
+      b_star_string_node *sib;
+    } leaf;
+    struct {
+      b_star_string_node *key_ptr[M];
+    } idx;
+  };
+  // the keys' bytes once they outgrow `heap`, `spill_cap` of them.
+  char *spill{};
+  len_t spill_cap{};
+  char heap[HEAP_BYTES];
+
+  b_star_string_node() = default;
+  b_star_string_node(const b_star_string_node &) = delete;
+  b_star_string_node &operator=(const b_star_string_node &) = delete;
+  ~b_star_string_node() {
+    delete[] spill;
+  }
+
+  const char *bytes_() const noexcept {
+    return spill ? spill : heap;
+  }
+
+  std::string_view prefix_() const noexcept {
+    return {bytes_() + pre_off, pre_len};
+  }
+
+  std::string_view suffix_(std::size_t i) const noexcept {
+    return {bytes_() + off[i], len[i]};
+  }
+
+  // fill in keys for the tree's overflow and underflow checks: the key count, or the live bytes against 7/8 of the
+  // heap when that is more, the last 1/8 takes the next keys. a handful of keys counts as it is, an index node
+  // needs a few to split at all, and a few long keys are left to `spill`.
+  std::size_t load_() const noexcept {
+    if (key_cnt < 8) return key_cnt;
+    return std::max<std::size_t>(key_cnt, std::size_t{live} * (M - 1) * 8 / (7 * HEAP_BYTES));
+  }
+
+  // once the tree has shrunk `key_cnt`, the slots past it hold nothing.
+  void trim_() noexcept {
+    for (std::size_t i = key_cnt; i < M - 1; i++) {
+      if (used.test(i)) drop_(i);
+    }
+  }
+
+  // keys `<= k` (INCLUSIVE) or `< k`.
+  template<bool INCLUSIVE>
+  std::size_t search_(std::string_view k) const noexcept {
+    std::string_view pre{prefix_()};
+    std::size_t n{std::min(pre.size(), k.size())};
+    int c{k.substr(0, n).compare(pre.substr(0, n))};
+    // every key starts with `pre`.
+    if (c < 0 || (c == 0 && k.size() < pre.size())) return 0;
+    if (c > 0) return key_cnt;
+    std::string_view rest{k.substr(n)};
+    std::size_t l{0}, r{key_cnt};
+    while (r > l) {
+      std::size_t mid{(l + r) / 2};
+      if (INCLUSIVE ? !(rest < suffix_(mid)) : suffix_(mid) < rest) {
+        l = mid + 1;
+      } else {
+        r = mid;
+      }
+    }
+    return l;
+  }
+
+  std::size_t find_idx_ptr_index_(std::string_view k) const noexcept {
+    return search_<true>(k);
+  }
+
+  std::size_t find_data_ptr_index_(std::string_view k) const noexcept {
+    return search_<false>(k);
+  }
+
+  val_type *val_ptr_(std::size_t i) noexcept {
+    if constexpr (INLINE_VAL) {
+      return &leaf.data[i];
+    } else {
+      return leaf.data[i];
+    }
+  }
+
+  b_split_key key_at_(std::size_t i) const noexcept {
+    return {prefix_(), suffix_(i)};
+  }
+
+  void set_key_(std::size_t i, std::string_view k) {
+    store_(i, {}, k);
+  }
+
+  void set_key_(std::size_t i, const b_split_key &k) {
+    store_(i, k.pre, k.suf);
+  }
+
+  // only the slot entries move, the bytes stay where they are.
+  void move_keys_(std::size_t to, std::size_t from, std::size_t n) noexcept {
+    if (n == 0 || to == from) return;
+    // the keys written over are garbage now.
+    for (std::size_t i = to; i < to + n; i++) {
+      if (used.test(i) && (i < from || i >= from + n)) live -= len[i];
+    }
+    std::memmove(off + to, off + from, n * sizeof(len_t));
+    std::memmove(len + to, len + from, n * sizeof(len_t));
+    for (std::size_t i = from; i < from + n; i++) {
+      if (i < to || i >= to + n) {
+        used.reset(i);
+        off[i] = 0;
+        len[i] = 0;
+      }
+    }
+    for (std::size_t i = to; i < to + n; i++) {
+      used.set(i);
+    }
+  }
+
+  void copy_keys_(std::size_t to, const b_star_string_node *src, std::size_t from, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+      set_key_(to + i, src->key_at_(from + i));
+    }
+  }
+
+  // the shortest prefix of the right leaf's first key that is still above the left leaf's last key.
+  static std::string separator_(const b_star_string_node *left, const b_star_string_node *right) {
+    std::string hi{right->key_at_(0)};
+    if (left->key_cnt == 0 || right->key_cnt == 0) return hi;
+    std::string lo{left->key_at_(left->key_cnt - 1)};
+    std::size_t n{0};
+    while (n < lo.size() && n < hi.size() && lo[n] == hi[n]) {
+      n++;
+    }
+    hi.resize(std::min(hi.size(), n + 1));
+    return hi;
+  }
+
+  // any length, see `spill`.
+  static constexpr bool key_fits_(std::string_view) noexcept {
+    return true;
+  }
+
+  static constexpr bool key_fits_(const b_split_key &) noexcept {
+    return true;
+  }
+
+private:
+  std::size_t cap_() const noexcept {
+    return spill ? spill_cap : HEAP_BYTES;
+  }
+
+  void drop_(std::size_t i) noexcept {
+    if (used.test(i)) live -= len[i];
+    used.reset(i);
+    off[i] = 0;
+    len[i] = 0;
+  }
+
+  // key `i` becomes `p + s`.
+  void store_(std::size_t i, std::string_view p, std::string_view s) {
+    drop_(i);
+    std::string_view pre{prefix_()};
+    std::size_t n{std::min(pre.size(), p.size())};
+    bool covered{p.substr(0, n) == pre.substr(0, n) && s.starts_with(pre.substr(n))};
+    // rebuild to drop the garbage, to derive a prefix once a second key shows up, or when `p + s` breaks the prefix.
+    if (!covered || top >= soft || (pre_len == 0 && used.count() == 1) ||
+        p.size() + s.size() > pre.size() + cap_() - top) {
+      rebuild_(i, p, s);
+      return;
+    }
+    // strip the node prefix.
+    std::string_view p_rest{p.substr(n)}, s_rest{s.substr(pre.size() - n)};
+    off[i] = top;
+    len[i] = static_cast<len_t>(p_rest.size() + s_rest.size());
+    char *dst{spill ? spill : heap};
+    p_rest.copy(dst + top, p_rest.size());
+    s_rest.copy(dst + top + p_rest.size(), s_rest.size());
+    top = static_cast<len_t>(top + len[i]);
+    live += len[i];
+    used.set(i);
+  }
+
+  // rewrites the heap without garbage around the longest prefix shared by all keys, `p + s` included as key `i`.
+  void rebuild_(std::size_t i, std::string_view p, std::string_view s) {
+    std::string buf{};
+    std::size_t from[M - 1]{}, cnt[M - 1]{};
+    std::string_view pre{prefix_()};
+    for (std::size_t j = 0; j < M - 1; j++) {
+      if (!used.test(j)) continue;
+      from[j] = buf.size();
+      buf.append(pre).append(suffix_(j));
+      cnt[j] = buf.size() - from[j];
+    }
+    from[i] = buf.size();
+    buf.append(p).append(s);
+    cnt[i] = buf.size() - from[i];
+    used.set(i);
+
+    std::string_view all{buf};
+    std::string_view first{all.substr(from[i], cnt[i])};
+    std::size_t lcp{first.size()}, keys{0};
+    for (std::size_t j = 0; j < M - 1; j++) {
+      if (!used.test(j)) continue;
+      std::string_view k{all.substr(from[j], cnt[j])};
+      std::size_t c{0};
+      while (c < lcp && c < k.size() && k[c] == first[c]) {
+        c++;
+      }
+      lcp = c;
+      keys++;
+    }
+    // a lone key keeps its bytes as a suffix, the next insert would break a full-key prefix anyway.
+    if (keys < 2) lcp = 0;
+
+    // the old bytes are all in `buf` by now.
+    std::size_t total{buf.size() - keys * lcp + lcp};
+    char *dst{heap};
+    if (total > HEAP_BYTES) {
+      if (spill_cap < total) {
+        delete[] spill;
+        spill_cap = static_cast<len_t>(2 * total);
+        spill = new char[spill_cap];
+      }
+      dst = spill;
+    } else {
+      delete[] std::exchange(spill, nullptr);
+      spill_cap = 0;
+    }
+
+    pre_off = 0;
+    pre_len = static_cast<len_t>(lcp);
+    first.copy(dst, lcp);
+    top = pre_len;
+    for (std::size_t j = 0; j < M - 1; j++) {
+      if (!used.test(j)) continue;
+      std::string_view k{all.substr(from[j] + lcp, cnt[j] - lcp)};
+      off[j] = top;
+      len[j] = static_cast<len_t>(k.size());
+      k.copy(dst + top, k.size());
+      top = static_cast<len_t>(top + k.size());
+    }
+    live = top;
+    // twice the live bytes keeps the rebuilds amortized.
+    soft = static_cast<len_t>(std::clamp<std::size_t>(2 * top, cap_() / 2, cap_()));
+  }
+};
@@ -0,0 +1,668 @@
+#pragma once
+#include "b_star_tree_refactored.h"
+
+/*================================================*\
+
+  Concurrent B*-tree, optimistic lock coupling.
+
+  Every node carries a version word.
+  Readers never write shared memory, they re-check
+  the versions they read and restart on a change.
+  Writers latch only the parent and the siblings
+  `fix_overflow_()` / `fix_underflow_()` may touch,
+  or the leaf itself.
+
+  Merged nodes are retired with an epoch and
+  recycled once no running operation can hold them.
+
+\*================================================*/
+
+// bit 0: obsolete, bit 1: locked, the rest counts modifications.
+struct b_olc_latch {
+  static constexpr std::uint64_t OBSOLETE = 1;
+  static constexpr std::uint64_t LOCKED = 2;
+  static constexpr int SPINS = 64;
+
+  std::atomic<std::uint64_t> word{0};
+
+  static void backoff_(int &spins) noexcept {
+    if (++spins < SPINS) {
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#endif
+      return;
+    }
+    spins = 0;
+    std::this_thread::yield();
+  }
+
+  // waits out a writer, false once the node is retired.
+  bool read_(std::uint64_t &v) const noexcept {
+    int spins{};
+    while ((v = word.load(std::memory_order_acquire)) & LOCKED) {
+      backoff_(spins);
+    }
+    return !(v & OBSOLETE);
+  }
+
+  bool validate_(std::uint64_t v) const noexcept {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return word.load(std::memory_order_relaxed) == v;
+  }
+
+  // takes the latch only if nothing changed since `v`.
+  bool upgrade_(std::uint64_t v) noexcept {
+    return word.compare_exchange_strong(v, v + LOCKED, std::memory_order_acquire);
+  }
+
+  // only for nodes that cannot be retired meanwhile, i.e. children of a latched parent.
+  void lock_() noexcept {
+    int spins{};
+    std::uint64_t v{word.load(std::memory_order_relaxed)};
+    while (true) {
+      if (!(v & LOCKED) && word.compare_exchange_weak(v, v + LOCKED, std::memory_order_acquire)) return;
+      backoff_(spins);
+      v = word.load(std::memory_order_relaxed);
+    }
+  }
+
+  // clears the lock bit and bumps the version.
+  void unlock_() noexcept {
+    word.fetch_add(LOCKED, std::memory_order_release);
+  }
+
+  // back to the version readers saw before, nothing was written.
+  void unlock_unchanged_() noexcept {
+    word.fetch_sub(LOCKED, std::memory_order_release);
+  }
+
+  void retire_() noexcept {
+    word.fetch_or(OBSOLETE, std::memory_order_release);
+  }
+};
+
+#if defined(__SANITIZE_THREAD__)
+#define B_OLC_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define B_OLC_TSAN 1
+#endif
+#endif
+
+#if defined(B_OLC_TSAN)
+extern "C" void AnnotateIgnoreReadsBegin(const char *file, int line);
+extern "C" void AnnotateIgnoreReadsEnd(const char *file, int line);
+#endif
+
+// optimistic reads race with latched writers by design, the version check throws away what they saw.
+// under -fsanitize=thread the reads in its scope are left out, writes are always checked.
+struct b_olc_optimistic {
+  b_olc_optimistic() noexcept {
+    begin_();
+  }
+  ~b_olc_optimistic() {
+    end_();
+  }
+  b_olc_optimistic(const b_olc_optimistic &) = delete;
+  b_olc_optimistic &operator=(const b_olc_optimistic &) = delete;
+
+  static void begin_() noexcept {
+#if defined(B_OLC_TSAN)
+    AnnotateIgnoreReadsBegin(__FILE__, __LINE__);
+#endif
+  }
+
+  static void end_() noexcept {
+#if defined(B_OLC_TSAN)
+    AnnotateIgnoreReadsEnd(__FILE__, __LINE__);
+#endif
+  }
+};
+
+// within a `b_olc_optimistic` scope, the reads of a latch holder or of the caller's code are checked again.
+struct b_olc_checked {
+  b_olc_checked() noexcept {
+    b_olc_optimistic::end_();
+  }
+  ~b_olc_checked() {
+    b_olc_optimistic::begin_();
+  }
+  b_olc_checked(const b_olc_checked &) = delete;
+  b_olc_checked &operator=(const b_olc_checked &) = delete;
+};
+
+template<typename key_type, typename val_type, std::size_t M, typename slot_type = val_type *>
+struct b_olc_node
+    : public b_base_node<key_type, val_type, M, b_olc_node<key_type, val_type, M, slot_type>, slot_type> {
+  b_olc_latch latch;
+};
+
+// Serializes the inner policy and defers `deallocate()` until every operation
+// pinned at that time has finished, so optimistic readers never touch recycled memory.
+// Over an arena, each thread takes nodes `BATCH` at a time, splits rarely meet on the mutex,
+// and hands what it has left back when it moves on to another tree or exits.
+template<typename node_type, typename inner_type = b_node_arena<node_type>>
+class b_olc_alloc {
+  static constexpr std::size_t SLOTS = 256;
+  static constexpr std::size_t RECLAIM_EVERY = 64;
+  static constexpr std::size_t BATCH = 16;
+  static constexpr int USER_BITS = 16;
+  static constexpr std::uint64_t USERS = (std::uint64_t{1} << USER_BITS) - 1;
+  // the arena owns every node, a batch whose allocator is gone went back with the slabs.
+  static constexpr bool CACHED = requires(inner_type &a) { a.release(); };
+
+  // 0 means idle, otherwise the global epoch seen when the first operation pinned on it started,
+  // shifted past the count of operations pinned on it.
+  struct alignas(64) epoch_slot {
+    std::atomic<std::uint64_t> epoch{0};
+  };
+
+  // a thread's nodes, taken from the allocator `owner` names.
+  struct local_cache {
+    std::uint64_t owner{};
+    std::size_t cnt{};
+    node_type *free[BATCH];
+
+    local_cache() = default;
+    local_cache(const local_cache &) = delete;
+    local_cache &operator=(const local_cache &) = delete;
+    ~local_cache() {
+      give_back_(*this);
+    }
+  };
+
+  // the allocators alive by id, so a cache never hands nodes to one already destroyed.
+  // taken before an allocator's `mtx`, never after.
+  struct registry {
+    std::mutex mtx{};
+    std::unordered_map<std::uint64_t, b_olc_alloc *> live{};
+  };
+
+  static registry &registry_() noexcept {
+    static registry r{};
+    return r;
+  }
+
+  static std::uint64_t next_id_() noexcept {
+    static std::atomic<std::uint64_t> ids{0};
+    return ++ids;
+  }
+
+  // back to the arena of `c.owner`, unless it was destroyed or released since and its slabs took them.
+  static void give_back_(local_cache &c) noexcept {
+    if (c.cnt == 0) return;
+    registry &r{registry_()};
+    std::lock_guard<std::mutex> lock{r.mtx};
+    if (auto it{r.live.find(c.owner)}; it != r.live.end()) {
+      std::lock_guard<std::mutex> owner{it->second->mtx};
+      for (; c.cnt > 0; c.cnt--) {
+        it->second->inner.deallocate(c.free[c.cnt - 1]);
+      }
+    }
+    c.cnt = 0;
+  }
+
+  inner_type inner{};
+  std::mutex mtx{};
+  // never reused, a thread's cache of a released allocator is dropped.
+  std::uint64_t id{next_id_()};
+  std::vector<std::pair<std::uint64_t, node_type *>> retired{};
+  std::size_t pending{};
+  std::atomic<std::uint64_t> global{1};
+  mutable epoch_slot slots[SLOTS]{};
+
+  // `mtx` held.
+  void reclaim_() noexcept {
+    std::uint64_t oldest{std::numeric_limits<std::uint64_t>::max()};
+    for (const epoch_slot &s : slots) {
+      std::uint64_t e{s.epoch.load() >> USER_BITS};
+      if (e && e < oldest) oldest = e;
+    }
+    std::size_t kept{};
+    for (auto [e, n] : retired) {
+      if (e < oldest) {
+        inner.deallocate(n);
+      } else {
+        retired[kept++] = {e, n};
+      }
+    }
+    retired.resize(kept);
+  }
+
+public:
+  class guard {
+    std::atomic<std::uint64_t> *slot;
+
+  public:
+    explicit guard(std::atomic<std::uint64_t> *s) noexcept : slot{s} {}
+    guard(const guard &) = delete;
+    guard &operator=(const guard &) = delete;
+    ~guard() {
+      // the last one out clears the epoch as well.
+      std::uint64_t w{slot->load(std::memory_order_relaxed)};
+      while (!slot->compare_exchange_weak(w, (w & USERS) == 1 ? 0 : w - 1, std::memory_order_release)) {}
+    }
+  };
+
+  b_olc_alloc() {
+    if constexpr (CACHED) {
+      std::lock_guard<std::mutex> lock{registry_().mtx};
+      registry_().live.emplace(id, this);
+    }
+  }
+  b_olc_alloc(const b_olc_alloc &) = delete;
+  b_olc_alloc &operator=(const b_olc_alloc &) = delete;
+  ~b_olc_alloc() {
+    if constexpr (CACHED) {
+      std::lock_guard<std::mutex> lock{registry_().mtx};
+      registry_().live.erase(id);
+    }
+    for (auto [e, n] : retired) {
+      inner.deallocate(n);
+    }
+  }
+
+  // announces an operation, nodes retired from now on outlive the returned guard.
+  [[nodiscard]] guard pin() const noexcept {
+    static thread_local std::size_t hint{std::hash<std::thread::id>{}(std::this_thread::get_id()) % SLOTS};
+    std::uint64_t e{global.load()};
+    for (std::size_t n = 0, i = hint; n < SLOTS; n++, i = (i + 1) % SLOTS) {
+      std::uint64_t idle{0};
+      if (slots[i].epoch.compare_exchange_strong(idle, e << USER_BITS | 1)) {
+        hint = i;
+        return guard{&slots[i].epoch};
+      }
+    }
+    // more threads than slots: join a busy one instead of waiting, its older epoch only keeps more nodes around.
+    std::atomic<std::uint64_t> &slot{slots[hint].epoch};
+    std::uint64_t w{slot.load()};
+    while (!slot.compare_exchange_weak(w, w ? w + 1 : e << USER_BITS | 1)) {}
+    return guard{&slot};
+  }
+
+  node_type *allocate() {
+    if constexpr (CACHED) {
+      static thread_local local_cache local{};
+      if (local.owner != id) {
+        give_back_(local);
+        local.owner = id;
+      }
+      if (local.cnt == 0) {
+        std::lock_guard<std::mutex> lock{mtx};
+        for (; local.cnt < BATCH; local.cnt++) {
+          local.free[local.cnt] = inner.allocate();
+        }
+      }
+      return local.free[--local.cnt];
+    } else {
+      std::lock_guard<std::mutex> lock{mtx};
+      return inner.allocate();
+    }
+  }
+
+  void deallocate(node_type *n) noexcept {
+    n->latch.retire_();
+    std::lock_guard<std::mutex> lock{mtx};
+    retired.emplace_back(global.fetch_add(1), n);
+    if (++pending == RECLAIM_EVERY) {
+      pending = 0;
+      reclaim_();
+    }
+  }
+
+  // no operation may be running, as for `stats()`.
+  std::size_t reserved_bytes() const noexcept
+    requires requires(const inner_type &a) { a.reserved_bytes(); }
+  {
+    return inner.reserved_bytes();
+  }
+
+  // no operation may be running.
+  void release() noexcept
+    requires requires(inner_type &a) { a.release(); }
+  {
+    retired.clear();
+    inner.release();
+    if constexpr (CACHED) {
+      std::lock_guard<std::mutex> lock{registry_().mtx};
+      registry_().live.erase(id);
+      id = next_id_();
+      registry_().live.emplace(id, this);
+    } else {
+      id = next_id_();
+    }
+  }
+};
+
+// `find_single`, `find_many`, `find_range`, `for_each_in_range`, `insert` and `erase` may run from any number of
+// threads.
+// The inherited bulk calls (`bulk_load`, `insert_batch`, `clear`, ...) and cursors still need the tree to themselves,
+// the other single-key writers, the fill policy calls and `reduce_range` are deleted.
+template<typename key_type, typename val_type, std::size_t M, typename node_type = b_olc_node<key_type, val_type, M>,
+         typename alloc_type = b_olc_alloc<node_type>, typename stats_type = b_no_stats>
+class b_star_tree_olc : public b_star_tree<key_type, val_type, M, node_type, alloc_type, stats_type> {
+protected:
+  using base = b_star_tree<key_type, val_type, M, node_type, alloc_type, stats_type>;
+  using typename base::slot_type;
+  using base::alloc;
+  using base::MAX_KEYS;
+  using base::root;
+
+  static_assert(std::is_trivially_copyable_v<key_type>, "readers copy keys while writers move them");
+
+  // guards the `root` pointer itself.
+  b_olc_latch root_latch{};
+
+  bool read_root_(node_type *&cur, std::uint64_t &v) const noexcept {
+    std::uint64_t rv{};
+    root_latch.read_(rv);
+    cur = root;
+    return cur->latch.read_(v) && root_latch.validate_(rv);
+  }
+
+  // optimistic descent, false when a version moved on.
+  bool find_leaf_(const key_type &k, node_type *&cur, std::uint64_t &v) const noexcept {
+    if (!read_root_(cur, v)) return false;
+    base::count_(b_event::DESCENTS);
+    while (!cur->is_leaf) {
+      base::count_(b_event::DESCENT_LEVELS);
+      node_type *next{cur->idx.key_ptr[cur->find_idx_ptr_index_(k)]};
+      std::uint64_t nv{};
+      if (!cur->latch.validate_(v) || !next->latch.read_(nv) || !cur->latch.validate_(v)) return false;
+      cur = next;
+      v = nv;
+    }
+    return true;
+  }
+
+  // latches `parent` at version `pv` and its children [idx - 2, idx + 2], the most a fix can touch.
+  // on success `pv` is the version the parent is left with.
+  bool fix_child_(node_type *parent, std::uint64_t &pv, std::size_t idx, bool overflow) noexcept {
+    if (!parent->latch.upgrade_(pv)) return false;
+    b_olc_checked latched{};
+    // a full parent cannot take another separator, its own parent fixes it on the next try.
+    if (overflow && this->is_overflow_(parent)) {
+      parent->latch.unlock_unchanged_();
+      return false;
+    }
+    node_type *held[5];
+    std::size_t cnt{};
+    for (std::size_t i = idx >= 2 ? idx - 2 : 0; i <= std::min(idx + 2, parent->key_cnt); i++) {
+      held[cnt] = parent->idx.key_ptr[i];
+      held[cnt++]->latch.lock_();
+    }
+    node_type *child{parent->idx.key_ptr[idx]};
+    bool fix{overflow ? this->is_overflow_(child) : this->is_underflow_(child)};
+    if (fix && overflow) this->fix_overflow_(child, parent, idx);
+    if (fix && !overflow) this->fix_underflow_(child, parent, idx);
+    for (std::size_t i = 0; i < cnt; i++) {
+      fix ? held[i]->latch.unlock_() : held[i]->latch.unlock_unchanged_();
+    }
+    if (fix) {
+      pv += 2 * b_olc_latch::LOCKED;
+      parent->latch.unlock_();
+    } else {
+      parent->latch.unlock_unchanged_();
+    }
+    return true;
+  }
+
+  // std::nullopt asks for a restart.
+  std::optional<bool> try_insert_(const key_type &k, slot_type v) noexcept {
+    b_olc_optimistic reads{};
+    node_type *cur{};
+    std::uint64_t cv{}, rv{};
+    root_latch.read_(rv);
+    cur = root;
+    if (!cur->latch.read_(cv) || !root_latch.validate_(rv)) return std::nullopt;
+    if (this->root_overflow_(cur)) {
+      if (!root_latch.upgrade_(rv)) return std::nullopt;
+      if (!cur->latch.upgrade_(cv)) {
+        root_latch.unlock_unchanged_();
+        return std::nullopt;
+      }
+      {
+        b_olc_checked latched{};
+        this->fix_root_overflow_();
+      }
+      cur->latch.unlock_();
+      root_latch.unlock_();
+      if (!read_root_(cur, cv)) return std::nullopt;
+    }
+    // as in `insert_down_to_leaf()`, each level is fixed once, then the descent goes on.
+    bool fixed{false};
+    base::count_(b_event::DESCENTS);
+    while (!cur->is_leaf) {
+      base::count_(b_event::DESCENT_LEVELS);
+      std::size_t next_from{cur->find_idx_ptr_index_(k)};
+      node_type *next{cur->idx.key_ptr[next_from]};
+      std::uint64_t nv{};
+      if (!cur->latch.validate_(cv) || !next->latch.read_(nv) || !cur->latch.validate_(cv)) return std::nullopt;
+      if (!fixed && this->is_overflow_(next)) {
+        if (!fix_child_(cur, cv, next_from, true)) return std::nullopt;
+        fixed = true;
+        continue;
+      }
+      fixed = false;
+      cur = next;
+      cv = nv;
+    }
+    if (!cur->latch.upgrade_(cv)) return std::nullopt;
+    b_olc_checked latched{};
+    // filled up by others after this descent fixed it.
+    if (this->is_overflow_(cur)) {
+      cur->latch.unlock_unchanged_();
+      return std::nullopt;
+    }
+    bool inserted{this->insert_leaf(cur, k, v)};
+    inserted ? cur->latch.unlock_() : cur->latch.unlock_unchanged_();
+    return inserted;
+  }
+
+  std::optional<bool> try_erase_(const key_type &k) noexcept {
+    b_olc_optimistic reads{};
+    node_type *cur{};
+    std::uint64_t cv{}, rv{};
+    root_latch.read_(rv);
+    cur = root;
+    if (!cur->latch.read_(cv) || !root_latch.validate_(rv)) return std::nullopt;
+    if (this->root_underflow_()) {
+      if (!root_latch.upgrade_(rv)) return std::nullopt;
+      if (!cur->latch.upgrade_(cv)) {
+        root_latch.unlock_unchanged_();
+        return std::nullopt;
+      }
+      {
+        b_olc_checked latched{};
+        node_type *node1{cur->idx.key_ptr[0]}, *node2{cur->idx.key_ptr[1]};
+        node1->latch.lock_();
+        node2->latch.lock_();
+        this->fix_root_underflow_();
+        node2->latch.unlock_();
+        node1->latch.unlock_();
+      }
+      cur->latch.unlock_();
+      root_latch.unlock_();
+      if (!read_root_(cur, cv)) return std::nullopt;
+    }
+    bool fixed{false};
+    base::count_(b_event::DESCENTS);
+    while (!cur->is_leaf) {
+      base::count_(b_event::DESCENT_LEVELS);
+      std::size_t next_from{cur->find_idx_ptr_index_(k)};
+      node_type *next{cur->idx.key_ptr[next_from]};
+      std::uint64_t nv{};
+      if (!cur->latch.validate_(cv) || !next->latch.read_(nv) || !cur->latch.validate_(cv)) return std::nullopt;
+      if (!fixed && this->is_underflow_(next)) {
+        if (!fix_child_(cur, cv, next_from, false)) return std::nullopt;
+        fixed = true;
+        continue;
+      }
+      fixed = false;
+      cur = next;
+      cv = nv;
+    }
+    if (!cur->latch.upgrade_(cv)) return std::nullopt;
+    b_olc_checked latched{};
+    bool erased{this->erase_leaf(cur, k)};
+    erased ? cur->latch.unlock_() : cur->latch.unlock_unchanged_();
+    return erased;
+  }
+
+public:
+  using typename base::cursor;
+
+  // writers split and free leaves side by side, nobody keeps the last one.
+  b_star_tree_olc() {
+    this->track_tail = false;
+  }
+
+  bool insert(const key_type &k, slot_type v) noexcept {
+    auto guard{alloc.pin()};
+    std::optional<bool> done{};
+    while (!(done = try_insert_(k, v))) {}
+    return *done;
+  }
+
+  bool erase(const key_type &k) noexcept {
+    auto guard{alloc.pin()};
+    std::optional<bool> done{};
+    while (!(done = try_erase_(k))) {}
+    return *done;
+  }
+
+  // a copy of the slot, leaf memory may be reused once the call returns.
+  std::optional<slot_type> find_single(const key_type &k) const noexcept {
+    auto guard{alloc.pin()};
+    b_olc_optimistic reads{};
+    while (true) {
+      node_type *cur{};
+      std::uint64_t v{};
+      if (!find_leaf_(k, cur, v)) continue;
+      std::size_t beg{cur->find_data_ptr_index_(k)};
+      bool hit{beg < cur->key_cnt && cur->key_at_(beg) == k};
+      slot_type s{hit ? cur->leaf.data[beg] : slot_type{}};
+      if (!cur->latch.validate_(v)) continue;
+      return hit ? std::optional<slot_type>{s} : std::nullopt;
+    }
+  }
+
+  // `out[i] = find_single(keys[i])` for `n` keys, returns how many were found. the descents of a group move one
+  // level at a time as in `b_star_tree::find_many()`, a key whose version moved on starts over from the root alone.
+  std::size_t find_many(const key_type *keys, std::size_t n, std::optional<slot_type> *out) const {
+    constexpr std::size_t GROUP = 16;
+    auto guard{alloc.pin()};
+    b_olc_optimistic reads{};
+    std::size_t found{};
+    node_type *cur[GROUP];
+    std::uint64_t ver[GROUP];
+    for (std::size_t beg = 0; beg < n; beg += GROUP) {
+      std::size_t cnt{std::min(GROUP, n - beg)}, left{cnt};
+      const key_type *k{keys + beg};
+      bool done[GROUP]{};
+      for (std::size_t j = 0; j < cnt; j++) {
+        while (!read_root_(cur[j], ver[j])) {}
+      }
+      base::count_(b_event::DESCENTS, cnt);
+      while (left > 0) {
+        for (std::size_t j = 0; j < cnt; j++) {
+          if (done[j]) continue;
+          node_type *c{cur[j]};
+          if (c->is_leaf) {
+            std::size_t i{c->find_data_ptr_index_(k[j])};
+            bool hit{i < c->key_cnt && c->key_at_(i) == k[j]};
+            slot_type s{hit ? c->leaf.data[i] : slot_type{}};
+            if (c->latch.validate_(ver[j])) {
+              out[beg + j] = hit ? std::optional<slot_type>{s} : std::nullopt;
+              found += hit;
+              done[j] = true;
+              left--;
+              continue;
+            }
+          } else {
+            base::count_(b_event::DESCENT_LEVELS);
+            node_type *next{c->idx.key_ptr[c->find_idx_ptr_index_(k[j])]};
+            std::uint64_t nv{};
+            if (c->latch.validate_(ver[j]) && next->latch.read_(nv) && c->latch.validate_(ver[j])) {
+              base::prefetch_node_(next);
+              cur[j] = next;
+              ver[j] = nv;
+              continue;
+            }
+          }
+          base::count_(b_event::DESCENTS);
+          while (!read_root_(cur[j], ver[j])) {}
+        }
+      }
+    }
+    return found;
+  }
+
+  // calls `fn(key, slot)` for every key in [low, high) without allocating, a `fn` returning bool stops on `false`.
+  // every leaf is copied out and validated before `fn` sees it, the range as a whole is not a snapshot.
+  // a restart resumes right after the last key visited.
+  template<typename visitor>
+  std::size_t for_each_in_range(const key_type &low, const key_type &high, visitor &&fn) const {
+    auto guard{alloc.pin()};
+    b_olc_optimistic reads{};
+    std::pair<key_type, slot_type> buf[MAX_KEYS];
+    std::size_t visited{};
+    key_type from{low};
+    bool resumed{false};
+    while (true) {
+      node_type *cur{};
+      std::uint64_t v{};
+      if (!find_leaf_(from, cur, v)) continue;
+      while (true) {
+        std::size_t cnt{cur->key_cnt}, n{};
+        std::size_t i{resumed ? cur->find_idx_ptr_index_(from) : cur->find_data_ptr_index_(from)};
+        for (; i < cnt && cur->key_at_(i) < high; i++) {
+          buf[n++] = {cur->key_at_(i), cur->leaf.data[i]};
+        }
+        node_type *next{cur->leaf.sib};
+        if (!cur->latch.validate_(v)) break;
+        b_olc_checked caller{};
+        for (std::size_t j = 0; j < n; j++) {
+          visited++;
+          if constexpr (std::is_same_v<std::invoke_result_t<visitor &, const key_type &, slot_type>, bool>) {
+            if (!fn(buf[j].first, buf[j].second)) return visited;
+          } else {
+            fn(buf[j].first, buf[j].second);
+          }
+        }
+        if (n) {
+          from = buf[n - 1].first;
+          resumed = true;
+        }
+        if (i < cnt || !next) return visited;
+        std::uint64_t nv{};
+        if (!next->latch.read_(nv) || !cur->latch.validate_(v)) break;
+        cur = next;
+        v = nv;
+      }
+    }
+  }
+
+  // [low, high), copies of (key, slot).
+  std::vector<std::pair<key_type, slot_type>> find_range(const key_type &low, const key_type &high) const {
+    std::vector<std::pair<key_type, slot_type>> vals{};
+    for_each_in_range(low, high, [&](const key_type &k, slot_type s) { vals.emplace_back(k, s); });
+    return vals;
+  }
+
+  // single-threaded writers of the plain tree, none of them latches.
+  std::pair<val_type *, bool> try_emplace(const key_type &k, slot_type v) = delete;
+  bool insert_or_assign(const key_type &k, slot_type v) = delete;
+  template<typename updater>
+  bool update(const key_type &k, slot_type init, updater &&fn) = delete;
+  cursor insert_hint(cursor hint, const key_type &k, slot_type v) = delete;
+  std::size_t erase_range(const key_type &low, const key_type &high) = delete;
+  bool compact_step(std::size_t max_parents = 1, double target_fill = 1.0) = delete;
+  void rebalance() = delete;
+  void set_low_water(std::size_t keys) = delete;
+
+  // walks leaves on several threads with neither a pin nor a version check, `for_each_in_range` folds instead.
+  template<typename acc_type, typename folder, typename merger>
+  acc_type reduce_range(const key_type &low, const key_type &high, acc_type init, folder &&fn, merger &&merge,
+                        std::size_t threads) const = delete;
+};
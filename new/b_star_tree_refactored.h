@@ -1,11 +1,20 @@
 #pragma once
 #include <bits/stdc++.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
 
 /*================================================*\
 
   B+*-tree,
   A B*-Tree based on B+-Tree,
-  Support duplicated keys.
+  Keys are unique, an insert of a key already there
+  fails. `b_star_multitree` in b_star_multitree.h
+  keeps duplicates.
 
   Each node has up to `M` branches,
   For index and leaf node, up to `M - 1` keys.
@@ -23,64 +32,694 @@ struct is_a_node<
                 decltype(typename node_type::key_t{std::declval<const typename node_type::key_t &>()})>>
     : std::true_type {};
 
-template<typename key_type, typename val_type, std::size_t M, typename Derived>
+/*================================================*\
+
+  Key search inside a node,
+  `INCLUSIVE == false` counts keys `< k` (lower bound),
+  `INCLUSIVE == true` counts keys `<= k` (upper bound).
+
+  Arithmetic keys narrow the range with a branchless
+  binary search, then count the last window with
+  AVX2 / SSE4.2 compares when the target has them.
+
+\*================================================*/
+
+template<typename key_type>
+inline constexpr bool b_simd_key_v = std::is_arithmetic_v<key_type> && !std::is_same_v<key_type, bool>;
+
+template<bool INCLUSIVE, typename key_type>
+std::size_t b_binary_search_(const key_type *key, std::size_t key_cnt, const key_type &k) noexcept {
+  std::size_t l{0}, r{key_cnt};
+  std::size_t mid{};
+  while (r > l) {
+    mid = (r - l) / 2 + l;
+    if (INCLUSIVE ? !(k < key[mid]) : key[mid] < k) {
+      l = mid + 1;
+    } else {
+      r = mid;
+    }
+  }
+  return r;
+}
+
+template<bool INCLUSIVE, typename key_type>
+std::size_t b_count_below_(const key_type *a, std::size_t n, key_type k) noexcept {
+  std::size_t i{0}, cnt{0};
+#if defined(__AVX2__)
+  if constexpr (std::is_integral_v<key_type> && sizeof(key_type) == 8) {
+    // unsigned keys compare as signed ones after flipping the sign bit.
+    const __m256i flip{_mm256_set1_epi64x(std::is_signed_v<key_type> ? 0 : std::numeric_limits<long long>::min())};
+    const __m256i kv{_mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(k)), flip)};
+    for (; i + 4 <= n; i += 4) {
+      __m256i x{_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)), flip)};
+      __m256i m{INCLUSIVE ? _mm256_cmpgt_epi64(x, kv) : _mm256_cmpgt_epi64(kv, x)};
+      std::size_t bits(std::popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(m)))));
+      cnt += INCLUSIVE ? 4 - bits : bits;
+    }
+  } else if constexpr (std::is_integral_v<key_type> && sizeof(key_type) == 4) {
+    const __m256i flip{_mm256_set1_epi32(std::is_signed_v<key_type> ? 0 : std::numeric_limits<int>::min())};
+    const __m256i kv{_mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(k)), flip)};
+    for (; i + 8 <= n; i += 8) {
+      __m256i x{_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)), flip)};
+      __m256i m{INCLUSIVE ? _mm256_cmpgt_epi32(x, kv) : _mm256_cmpgt_epi32(kv, x)};
+      std::size_t bits(std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m)))));
+      cnt += INCLUSIVE ? 8 - bits : bits;
+    }
+  } else if constexpr (std::is_same_v<key_type, double>) {
+    const __m256d kv{_mm256_set1_pd(k)};
+    for (; i + 4 <= n; i += 4) {
+      __m256d m{_mm256_cmp_pd(_mm256_loadu_pd(a + i), kv, INCLUSIVE ? _CMP_LE_OQ : _CMP_LT_OQ)};
+      cnt += std::popcount(static_cast<unsigned>(_mm256_movemask_pd(m)));
+    }
+  } else if constexpr (std::is_same_v<key_type, float>) {
+    const __m256 kv{_mm256_set1_ps(k)};
+    for (; i + 8 <= n; i += 8) {
+      __m256 m{_mm256_cmp_ps(_mm256_loadu_ps(a + i), kv, INCLUSIVE ? _CMP_LE_OQ : _CMP_LT_OQ)};
+      cnt += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(m)));
+    }
+  }
+#elif defined(__SSE4_2__)
+  if constexpr (std::is_integral_v<key_type> && sizeof(key_type) == 8) {
+    const __m128i flip{_mm_set1_epi64x(std::is_signed_v<key_type> ? 0 : std::numeric_limits<long long>::min())};
+    const __m128i kv{_mm_xor_si128(_mm_set1_epi64x(static_cast<long long>(k)), flip)};
+    for (; i + 2 <= n; i += 2) {
+      __m128i x{_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)), flip)};
+      __m128i m{INCLUSIVE ? _mm_cmpgt_epi64(x, kv) : _mm_cmpgt_epi64(kv, x)};
+      std::size_t bits(std::popcount(static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(m)))));
+      cnt += INCLUSIVE ? 2 - bits : bits;
+    }
+  } else if constexpr (std::is_integral_v<key_type> && sizeof(key_type) == 4) {
+    const __m128i flip{_mm_set1_epi32(std::is_signed_v<key_type> ? 0 : std::numeric_limits<int>::min())};
+    const __m128i kv{_mm_xor_si128(_mm_set1_epi32(static_cast<int>(k)), flip)};
+    for (; i + 4 <= n; i += 4) {
+      __m128i x{_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)), flip)};
+      __m128i m{INCLUSIVE ? _mm_cmpgt_epi32(x, kv) : _mm_cmpgt_epi32(kv, x)};
+      std::size_t bits(std::popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m)))));
+      cnt += INCLUSIVE ? 4 - bits : bits;
+    }
+  } else if constexpr (std::is_same_v<key_type, double>) {
+    const __m128d kv{_mm_set1_pd(k)};
+    for (; i + 2 <= n; i += 2) {
+      __m128d m{INCLUSIVE ? _mm_cmple_pd(_mm_loadu_pd(a + i), kv) : _mm_cmplt_pd(_mm_loadu_pd(a + i), kv)};
+      cnt += std::popcount(static_cast<unsigned>(_mm_movemask_pd(m)));
+    }
+  } else if constexpr (std::is_same_v<key_type, float>) {
+    const __m128 kv{_mm_set1_ps(k)};
+    for (; i + 4 <= n; i += 4) {
+      __m128 m{INCLUSIVE ? _mm_cmple_ps(_mm_loadu_ps(a + i), kv) : _mm_cmplt_ps(_mm_loadu_ps(a + i), kv)};
+      cnt += std::popcount(static_cast<unsigned>(_mm_movemask_ps(m)));
+    }
+  }
+#endif
+  // by pointer, an index loop here trips -Waggressive-loop-optimizations once `n` is a constant, as in `b_star_frozen`.
+  for (const key_type *p = a + i, *last = a + n; p < last; p++) {
+    cnt += INCLUSIVE ? !(k < *p) : (*p < k);
+  }
+  return cnt;
+}
+
+template<bool INCLUSIVE, typename key_type>
+std::size_t b_branchless_search_(const key_type *key, std::size_t key_cnt, key_type k) noexcept {
+  // two cache lines are counted at once.
+  constexpr std::size_t WINDOW{std::clamp<std::size_t>(128 / sizeof(key_type), 8, 32)};
+  const key_type *base{key};
+  std::size_t len{key_cnt};
+  // key[0, base) is always on the left of the answer.
+  // cmov hides the branch but not the next load, so both candidates are prefetched.
+  while (len > WINDOW) {
+    std::size_t half{len / 2};
+    __builtin_prefetch(base + half / 2);
+    __builtin_prefetch(base + half + half / 2);
+    base = (INCLUSIVE ? !(k < base[half]) : base[half] < k) ? base + half : base;
+    len -= half;
+  }
+  return static_cast<std::size_t>(base - key) + b_count_below_<INCLUSIVE>(base, len, k);
+}
+
+// the index arm of a node, a summary per child next to the child pointers unless `summary_type` is void.
+template<typename Derived, std::size_t M, typename summary_type>
+struct b_idx_arm {
+  Derived *key_ptr[M];
+  summary_type sum[M];
+};
+
+template<typename Derived, std::size_t M>
+struct b_idx_arm<Derived, M, void> {
+  Derived *key_ptr[M];
+};
+
+// `slot_type` is what a leaf stores per key,
+// `val_type *` points at caller-owned values, `val_type` keeps them inline.
+template<typename key_type, typename val_type, std::size_t M, typename Derived, typename slot_type = val_type *,
+         typename summary_type = void>
 struct b_base_node {
 
   using key_t = key_type;
   using val_t = val_type;
+  using slot_t = slot_type;
+
+  static constexpr bool INLINE_VAL = std::is_same_v<slot_type, val_type>;
+  static constexpr bool RAW_KEYS = std::is_trivially_copyable_v<key_type>;
+  // index nodes keep a summary per child in `idx.sum[]`, see `b_star_augmented_node`.
+  static constexpr bool AUGMENTED = false;
+  static_assert(INLINE_VAL || std::is_same_v<slot_type, val_type *>);
+  static_assert(std::is_trivially_copyable_v<slot_type>, "slots are moved with memmove");
 
   std::size_t key_cnt;
   bool is_leaf;
   key_type key[M - 1];
   union {
     struct {
-      val_type *data_ptr[M - 1];
+      slot_type data[M - 1];
       Derived *sib;
     } leaf;
-    struct {
-      Derived *key_ptr[M];
-    } idx;
+    b_idx_arm<Derived, M, summary_type> idx;
   };
 
+  // key[-1, l) <= val, key[r, key_cnt + 1) > val.
   std::size_t find_idx_ptr_index_(const key_type &k) noexcept {
-    std::size_t l{0}, r{key_cnt};
-    std::size_t mid{};
-    // key[-1, l) <= val, key[r, key_cnt + 1) > val.
-    while (r > l) {
-      mid = (r - l) / 2 + l;
-      if (!(k < key[mid])) {
-        l = mid + 1;
-      } else {
-        r = mid;
-      }
+    if constexpr (b_simd_key_v<key_type>) {
+      return b_branchless_search_<true>(key, key_cnt, k);
+    } else {
+      return b_binary_search_<true>(key, key_cnt, k);
     }
-    return r;
   }
 
+  // key[-1, l) < val, key[r, key_cnt + 1) >= val.
   std::size_t find_data_ptr_index_(const key_type &k) noexcept {
-    std::size_t l{0}, r{key_cnt};
-    std::size_t mid{};
-    // key[-1, l) < val, key[r, key_cnt + 1) >= val.
-    while (r > l) {
-      mid = (r - l) / 2 + l;
-      if (key[mid] < k) {
-        l = mid + 1;
-      } else {
-        r = mid;
-      }
+    if constexpr (b_simd_key_v<key_type>) {
+      return b_branchless_search_<false>(key, key_cnt, k);
+    } else {
+      return b_binary_search_<false>(key, key_cnt, k);
+    }
+  }
+
+  val_type *val_ptr_(std::size_t i) noexcept {
+    if constexpr (INLINE_VAL) {
+      return &leaf.data[i];
+    } else {
+      return leaf.data[i];
+    }
+  }
+
+  // key primitives, the tree never touches `key[]` directly,
+  // so a node type may store its keys any other way.
+
+  const key_type &key_at_(std::size_t i) const noexcept {
+    return key[i];
+  }
+
+  void set_key_(std::size_t i, const key_type &k) {
+    key[i] = k;
+  }
+
+  // [from, from + n) to [to, to + n) inside this node, the ranges may overlap.
+  void move_keys_(std::size_t to, std::size_t from, std::size_t n) noexcept {
+    if constexpr (RAW_KEYS) {
+      std::memmove(key + to, key + from, n * sizeof(key_type));
+    } else if (to < from) {
+      std::move(key + from, key + from + n, key + to);
+    } else {
+      std::move_backward(key + from, key + from + n, key + to + n);
+    }
+  }
+
+  // [from, from + n) of `src` to [to, to + n), `src != this`.
+  void copy_keys_(std::size_t to, const Derived *src, std::size_t from, std::size_t n) {
+    if constexpr (RAW_KEYS) {
+      std::memcpy(key + to, src->key + from, n * sizeof(key_type));
+    } else {
+      std::copy(src->key + from, src->key + from + n, key + to);
     }
-    return r;
+  }
+
+  // the parent key between two neighbouring leaves.
+  static const key_type &separator_(const Derived *, const Derived *right) noexcept {
+    return right->key[0];
+  }
+
+  static constexpr bool key_fits_(const key_type &) noexcept {
+    return true;
   }
 };
 
 template<typename key_type, typename val_type, std::size_t M>
 struct b_star_node : public b_base_node<key_type, val_type, M, b_star_node<key_type, val_type, M>> {};
 
+// small trivially copyable values live in the leaf, no extra cache miss on a hit.
+template<typename key_type, typename val_type, std::size_t M>
+struct b_star_inline_node
+    : public b_base_node<key_type, val_type, M, b_star_inline_node<key_type, val_type, M>, val_type> {};
+
+// starts on a cache line, so the header and the first keys share one line
+// and a node of `k` lines never straddles `k + 1`.
+template<typename key_type, typename val_type, std::size_t M, std::size_t ALIGN = 64, typename slot_type = val_type *>
+struct alignas(ALIGN) b_star_aligned_node
+    : public b_base_node<key_type, val_type, M, b_star_aligned_node<key_type, val_type, M, ALIGN, slot_type>,
+                         slot_type> {};
+
+/*================================================*\
+
+  Fanout from a node size,
+  `b_fanout_for_bytes<key_type, slot_type>(bytes)`
+  is the largest `M` whose `b_base_node` fits in
+  `bytes`, e.g. 256 B, 1 KiB or a 4 KiB page,
+  0 when not even `M = 7`, the smallest tree, does.
+
+\*================================================*/
+
+constexpr std::size_t b_round_up_(std::size_t n, std::size_t a) noexcept {
+  return (n + a - 1) / a * a;
+}
+
+// mirrors the member order of `b_base_node`.
+template<typename key_type, typename slot_type>
+constexpr std::size_t b_node_bytes_(std::size_t m) noexcept {
+  constexpr std::size_t PTR_ALIGN = std::max(alignof(slot_type), alignof(void *));
+  constexpr std::size_t ALIGN = std::max({alignof(std::size_t), alignof(key_type), PTR_ALIGN});
+  std::size_t keys{b_round_up_(sizeof(std::size_t) + sizeof(bool), alignof(key_type)) + (m - 1) * sizeof(key_type)};
+  std::size_t ptrs{std::max((m - 1) * sizeof(slot_type) + sizeof(void *), m * sizeof(void *))};
+  return b_round_up_(b_round_up_(keys, PTR_ALIGN) + ptrs, ALIGN);
+}
+
+template<typename key_type, typename slot_type>
+constexpr std::size_t b_fanout_for_bytes(std::size_t bytes) noexcept {
+  if (b_node_bytes_<key_type, slot_type>(7) > bytes) return 0;
+  std::size_t m{7};
+  while (b_node_bytes_<key_type, slot_type>(m + 1) <= bytes) m++;
+  return m;
+}
+
+// true unless `node_type` is built on the plain `b_base_node` and `b_node_bytes_` misjudges its size.
+template<typename key_type, typename val_type, std::size_t M, typename node_type>
+constexpr bool b_node_bytes_match_() noexcept {
+  using base_node = b_base_node<key_type, val_type, M, node_type, typename node_type::slot_t>;
+  if constexpr (std::is_base_of_v<base_node, node_type>) {
+    return b_node_bytes_<key_type, typename node_type::slot_t>(M) == sizeof(base_node);
+  } else {
+    return true;
+  }
+}
+
+/*================================================*\
+
+  Node allocator policies,
+  `allocate()` hands out an uninitialized node,
+  `deallocate()` takes it back.
+  An optional `release()` drops every node at once,
+  an optional `allocate(is_leaf)` may hand out
+  leaves of `b_leaf_bytes_` only.
+
+\*================================================*/
+
+// what a leaf of `node_type` uses, less than the node when index nodes carry more, see `b_star_augmented_node`.
+template<typename node_type>
+constexpr std::size_t b_leaf_bytes_() noexcept {
+  if constexpr (requires { node_type::leaf_bytes_(); }) {
+    return node_type::leaf_bytes_();
+  } else {
+    return sizeof(node_type);
+  }
+}
+
+template<typename node_type>
+struct b_node_new_delete {
+  node_type *allocate() {
+    return new node_type;
+  }
+
+  void deallocate(node_type *n) noexcept {
+    delete n;
+  }
+};
+
+// Nodes are carved from fixed-size slabs and recycled through a free list.
+// `release()` unmaps the slabs, so `clear()` and destruction never walk the tree.
+template<typename node_type, std::size_t SLAB_BYTES = (std::size_t{1} << 20), bool HUGE_PAGES = false>
+class b_node_arena {
+  static_assert(std::is_trivially_destructible_v<node_type>, "slabs are released without running destructors");
+
+  struct slab_header {
+    slab_header *prev;
+    std::size_t bytes;
+  };
+
+  struct free_link {
+    free_link *next;
+  };
+
+  static constexpr std::size_t round_up_(std::size_t n, std::size_t a) noexcept {
+    return (n + a - 1) / a * a;
+  }
+
+  static constexpr std::size_t PAGE = 4096;
+  static constexpr std::size_t HUGE_PAGE = std::size_t{1} << 21;
+  static constexpr std::size_t ALIGN = std::max(alignof(node_type), alignof(free_link));
+  static constexpr std::size_t STRIDE = round_up_(std::max(sizeof(node_type), sizeof(free_link)), ALIGN);
+  static constexpr std::size_t HEADER = round_up_(sizeof(slab_header), ALIGN);
+  static constexpr std::size_t SLAB = round_up_(std::max(SLAB_BYTES, HEADER + 8 * STRIDE), HUGE_PAGES ? HUGE_PAGE : PAGE);
+  static_assert(ALIGN <= PAGE);
+
+  slab_header *slabs_{};
+  std::byte *bump_{}, *bump_end_{};
+  free_link *free_{};
+  std::size_t slab_cnt_{};
+
+  void new_slab_() {
+    void *mem{MAP_FAILED};
+    if constexpr (HUGE_PAGES) {
+      mem = ::mmap(nullptr, SLAB, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (mem == MAP_FAILED) {
+      mem = ::mmap(nullptr, SLAB, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (mem == MAP_FAILED) throw std::bad_alloc{};
+      // no reserved huge pages, let THP back the slab instead.
+      if constexpr (HUGE_PAGES) ::madvise(mem, SLAB, MADV_HUGEPAGE);
+    }
+    slab_header *slab{static_cast<slab_header *>(mem)};
+    slab->prev = slabs_;
+    slab->bytes = SLAB;
+    slabs_ = slab;
+    slab_cnt_++;
+    bump_ = static_cast<std::byte *>(mem) + HEADER;
+    bump_end_ = static_cast<std::byte *>(mem) + SLAB;
+  }
+
+public:
+  b_node_arena() noexcept = default;
+  ~b_node_arena() {
+    release();
+  }
+
+  b_node_arena(const b_node_arena &obj) = delete;
+  b_node_arena(b_node_arena &&obj) noexcept
+      : slabs_{std::exchange(obj.slabs_, nullptr)}, bump_{std::exchange(obj.bump_, nullptr)},
+        bump_end_{std::exchange(obj.bump_end_, nullptr)}, free_{std::exchange(obj.free_, nullptr)},
+        slab_cnt_{std::exchange(obj.slab_cnt_, 0)} {}
+
+  b_node_arena &operator=(const b_node_arena &obj) = delete;
+  b_node_arena &operator=(b_node_arena &&obj) noexcept {
+    if (this != &obj) {
+      release();
+      slabs_ = std::exchange(obj.slabs_, nullptr);
+      bump_ = std::exchange(obj.bump_, nullptr);
+      bump_end_ = std::exchange(obj.bump_end_, nullptr);
+      free_ = std::exchange(obj.free_, nullptr);
+      slab_cnt_ = std::exchange(obj.slab_cnt_, 0);
+    }
+    return *this;
+  }
+
+  node_type *allocate() {
+    void *p{};
+    if (free_) {
+      p = free_;
+      free_ = free_->next;
+    } else {
+      if (bump_ == bump_end_ || static_cast<std::size_t>(bump_end_ - bump_) < STRIDE) new_slab_();
+      p = bump_;
+      bump_ += STRIDE;
+    }
+    return ::new (p) node_type;
+  }
+
+  void deallocate(node_type *n) noexcept {
+    free_link *link{reinterpret_cast<free_link *>(n)};
+    link->next = free_;
+    free_ = link;
+  }
+
+  void release() noexcept {
+    while (slabs_) {
+      slab_header *prev{slabs_->prev};
+      ::munmap(slabs_, slabs_->bytes);
+      slabs_ = prev;
+    }
+    bump_ = bump_end_ = nullptr;
+    free_ = nullptr;
+    slab_cnt_ = 0;
+  }
+
+  std::size_t reserved_bytes() const noexcept {
+    return slab_cnt_ * SLAB;
+  }
+};
+
+// leaves and index nodes from arenas of their own, each leaf takes only `b_leaf_bytes_` of a slab.
+// a node goes back to the arena its `is_leaf` names.
+template<typename node_type, std::size_t SLAB_BYTES = (std::size_t{1} << 20), bool HUGE_PAGES = false>
+class b_node_split_arena {
+  struct alignas(node_type) leaf_block {
+    std::byte bytes[b_leaf_bytes_<node_type>()];
+  };
+  static_assert(sizeof(leaf_block) <= sizeof(node_type));
+
+  b_node_arena<leaf_block, SLAB_BYTES, HUGE_PAGES> leaves{};
+  b_node_arena<node_type, SLAB_BYTES, HUGE_PAGES> inner{};
+
+public:
+  node_type *allocate(bool is_leaf) {
+    return is_leaf ? reinterpret_cast<node_type *>(leaves.allocate()) : inner.allocate();
+  }
+
+  node_type *allocate() {
+    return inner.allocate();
+  }
+
+  void deallocate(node_type *n) noexcept {
+    if (n->is_leaf) {
+      leaves.deallocate(reinterpret_cast<leaf_block *>(n));
+    } else {
+      inner.deallocate(n);
+    }
+  }
+
+  void release() noexcept {
+    leaves.release();
+    inner.release();
+  }
+
+  std::size_t reserved_bytes() const noexcept {
+    return leaves.reserved_bytes() + inner.reserved_bytes();
+  }
+};
+
+/*================================================*\
+
+  Structural event counters,
+  the `stats_type` policy of `b_star_tree`.
+
+  `b_no_stats` compiles every count away,
+  `b_thread_stats<tag>` keeps one set of counters
+  per thread, read with `snapshot()` and cleared
+  with `reset()` from that thread. The workers of
+  `bulk_load_parallel()` and `reduce_range()` hand
+  their counts to the thread that called them.
+
+\*================================================*/
+
+enum class b_event : std::size_t {
+  SPLIT_1_2,
+  MERGE_2_1,
+  SPLIT_2_3,
+  MERGE_3_2,
+  EQUAL_SPLIT_2,
+  EQUAL_SPLIT_3,
+  REDISTRIBUTE,
+  ROOT_OVERFLOW,
+  ROOT_UNDERFLOW,
+  NODE_ALLOC,
+  NODE_FREE,
+  // keys and slots shifted or copied between nodes, and inside a leaf on insert / erase.
+  MOVED_BYTES,
+  DESCENTS,
+  // levels walked by all descents, over `DESCENTS` it is the average depth.
+  DESCENT_LEVELS,
+  // nodes copied before a write because a snapshot still reads them, see `b_star_cow_tree`.
+  NODE_COPY,
+  // batches of buffered writes moved a level down, see `b_star_buffered_tree`.
+  BUFFER_FLUSH,
+  COUNT
+};
+
+constexpr const char *b_event_name(b_event e) noexcept {
+  constexpr const char *NAMES[]{
+      "split_1_2",     "merge_2_1",      "split_2_3",  "merge_3_2", "equal_split_2", "equal_split_3", "redistribute",
+      "root_overflow", "root_underflow", "node_alloc", "node_free", "moved_bytes",   "descents",      "descent_levels",
+      "node_copy",     "buffer_flush",
+  };
+  static_assert(std::size(NAMES) == static_cast<std::size_t>(b_event::COUNT));
+  return NAMES[static_cast<std::size_t>(e)];
+}
+
+struct b_stats_snapshot {
+  std::array<std::uint64_t, static_cast<std::size_t>(b_event::COUNT)> cnt{};
+
+  std::uint64_t operator[](b_event e) const noexcept {
+    return cnt[static_cast<std::size_t>(e)];
+  }
+
+  // sums the snapshots of several threads.
+  b_stats_snapshot &operator+=(const b_stats_snapshot &obj) noexcept {
+    for (std::size_t i = 0; i < cnt.size(); i++) {
+      cnt[i] += obj.cnt[i];
+    }
+    return *this;
+  }
+};
+
+struct b_no_stats {
+  static constexpr bool ENABLED = false;
+
+  static void add(b_event, std::uint64_t = 1) noexcept {}
+};
+
+// trees with the same `tag` share the counters of a thread.
+template<typename tag = void>
+struct b_thread_stats {
+  static constexpr bool ENABLED = true;
+
+  static b_stats_snapshot &local_() noexcept {
+    thread_local b_stats_snapshot s{};
+    return s;
+  }
+
+  static void add(b_event e, std::uint64_t n = 1) noexcept {
+    local_().cnt[static_cast<std::size_t>(e)] += n;
+  }
+
+  static b_stats_snapshot snapshot() noexcept {
+    return local_();
+  }
+
+  static void reset() noexcept {
+    local_() = {};
+  }
+};
+
+// the shape of a tree, `b_star_tree::stats()`.
+struct b_tree_stats {
+  std::size_t height{};
+  std::size_t nodes{}, leaves{}, keys{};
+  // `nodes * sizeof(node)`, and what the allocator holds when it can tell, free nodes included.
+  std::size_t bytes{}, reserved_bytes{};
+  // leaves by fill, `fill[i]` counts leaves holding [i / 10, (i + 1) / 10) of `M - 1` keys, full ones in `fill[9]`.
+  std::array<std::size_t, 10> fill{};
+  // sibling links to the very next node in memory, a freshly compacted tree has `leaves - 1` of them.
+  std::size_t adjacent_leaves{};
+};
+
+/*================================================*\
+
+  Fork-join over a few threads,
+  `b_parallel_for(threads, n, fn)` calls `fn(i)` for
+  every i in [0, n), the calling thread included,
+  handing the indices out in order as workers free
+  up. Returns once all of them are done.
+
+\*================================================*/
+
+template<typename job>
+void b_parallel_for(std::size_t threads, std::size_t n, job &&fn) {
+  std::atomic<std::size_t> next{0};
+  auto work = [&] {
+    for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < n;) {
+      fn(i);
+    }
+  };
+  std::vector<std::thread> pool{};
+  for (std::size_t t = 1; t < std::min(threads, n); t++) {
+    pool.emplace_back(work);
+  }
+  work();
+  for (std::thread &t : pool) {
+    t.join();
+  }
+}
+
+/*================================================*\
+
+  On-disk image,
+  written by `b_star_tree::save()`, served by
+  `b_star_mapped::open_mapped()` straight from a
+  read-only `mmap`, nothing is deserialized.
+
+  Page 0 is the header, the nodes follow in level
+  order, children and siblings are page numbers
+  (0 stands for none). Keys and values are stored
+  by value in the byte order of the host.
+
+\*================================================*/
+
+struct b_image_header {
+  static constexpr std::uint64_t MAGIC = 0x3130474d49545342; // "BSTIMG01" in little endian
+
+  std::uint64_t magic;
+  std::uint64_t m;
+  std::uint64_t key_bytes;
+  std::uint64_t val_bytes;
+  std::uint64_t page_bytes;
+  std::uint64_t root;
+  std::uint64_t page_cnt;
+  std::uint64_t size;
+};
+
+template<typename key_type, typename val_type, std::size_t M>
+struct b_image_page {
+  static_assert(std::is_trivially_copyable_v<key_type> && std::is_trivially_copyable_v<val_type>,
+                "an image stores keys and values by value");
+
+  std::uint64_t key_cnt;
+  std::uint64_t is_leaf;
+  key_type key[M - 1];
+  union {
+    struct {
+      val_type data[M - 1];
+      std::uint64_t sib;
+    } leaf;
+    struct {
+      std::uint64_t key_ptr[M];
+    } idx;
+  };
+};
+
+// every page, the header's included, takes the same whole number of cache lines.
+template<typename key_type, typename val_type, std::size_t M>
+inline constexpr std::size_t b_image_page_bytes_ =
+    b_round_up_(std::max(sizeof(b_image_page<key_type, val_type, M>), sizeof(b_image_header)), 64);
+
+// node width of `b_star_frozen`, two cache lines of keys like the last window of `b_branchless_search_`.
+template<typename key_type>
+inline constexpr std::size_t b_frozen_width_ = std::max<std::size_t>(128 / sizeof(key_type), 4);
+
+template<typename key_type, typename val_type, std::size_t B = b_frozen_width_<key_type>>
+class b_star_frozen;
+
+// nodes owning non-trivial keys, e.g. `std::string`, need their destructors run.
+template<typename node_type>
+using b_node_default_alloc =
+    std::conditional_t<std::is_trivially_destructible_v<node_type>, b_node_arena<node_type>, b_node_new_delete<node_type>>;
+
 template<typename key_type, typename val_type, std::size_t M, typename node_type = b_star_node<key_type, val_type, M>,
+         typename alloc_type = b_node_default_alloc<node_type>, typename stats_type = b_no_stats,
          typename Requires = std::void_t<std::enable_if_t<is_a_node<node_type>::value && M >= 7>>>
 class b_star_tree {
 protected:
+  // `val_type *` or `val_type`, depending on the node.
+  using slot_type = typename node_type::slot_t;
+  // what `key_at_()` hands out, `const key_type &` unless the node stores keys its own way.
+  using key_ref = decltype(std::declval<const node_type &>().key_at_(0));
+
+  static_assert(b_node_bytes_match_<key_type, val_type, M, node_type>(),
+                "b_node_bytes_ no longer mirrors b_base_node, b_fanout_for_bytes would pick the wrong M");
+
   node_type *root{};
+  alloc_type alloc{};
+  // the rightmost leaf, found again after it was freed. a tree shared by writers leaves it off.
+  node_type *tail{};
+  bool track_tail{true};
+  // erases fix a node once it is down to this many keys, see `set_low_water()`.
+  std::size_t low_water{MIN_KEYS};
   static constexpr std::size_t KEY_SLOTS = M - 1;
   static constexpr std::size_t MAX_KEYS = KEY_SLOTS;
 
@@ -89,20 +728,123 @@ protected:
   // 2-3 split MUST be successful if equal-split-3 is failed.
   static constexpr std::size_t MIN_KEYS = (2 * MAX_KEYS - 5) / 3;
 
-private:
+  // a key plus the wider of a slot and a child pointer.
+  static constexpr std::size_t ENTRY_BYTES = sizeof(key_type) + std::max(sizeof(slot_type), sizeof(node_type *));
+
+  static void count_(b_event e, std::uint64_t n = 1) noexcept {
+    if constexpr (stats_type::ENABLED) stats_type::add(e, n);
+  }
+
+  // `b_parallel_for()`, with what the workers counted handed over to the calling thread, whose `snapshot()` then
+  // covers the whole call.
+  template<typename job>
+  static void parallel_for_(std::size_t threads, std::size_t n, job &&fn) {
+    if constexpr (requires { stats_type::snapshot(); stats_type::reset(); }) {
+      std::thread::id caller{std::this_thread::get_id()};
+      std::mutex lock{};
+      b_stats_snapshot workers{};
+      b_parallel_for(threads, n, [&](std::size_t i) {
+        fn(i);
+        if (std::this_thread::get_id() == caller) return;
+        b_stats_snapshot mine{stats_type::snapshot()};
+        stats_type::reset();
+        std::lock_guard guard{lock};
+        workers += mine;
+      });
+      for (std::size_t e = 0; e < workers.cnt.size(); e++) {
+        if (workers.cnt[e] != 0) stats_type::add(static_cast<b_event>(e), workers.cnt[e]);
+      }
+    } else {
+      b_parallel_for(threads, n, fn);
+    }
+  }
+
+  // summaries of augmented nodes travel with the child pointers, and are refreshed where a child changes.
+  static void move_sums_(node_type *to, std::size_t to_i, const node_type *from, std::size_t from_i,
+                         std::size_t n) noexcept {
+    if constexpr (node_type::AUGMENTED) std::memmove(to->idx.sum + to_i, from->idx.sum + from_i, n * sizeof(to->idx.sum[0]));
+  }
+
+  static void refresh_sum_(node_type *parent, std::size_t i) noexcept {
+    if constexpr (node_type::AUGMENTED) parent->idx.sum[i] = node_type::total_(parent->idx.key_ptr[i]);
+  }
+
+  // fill in keys, a node type weighing its keys by bytes as well reports more once they run short.
+  static std::size_t load_(const node_type *n) noexcept {
+    if constexpr (requires { n->load_(); }) {
+      return n->load_();
+    } else {
+      return n->key_cnt;
+    }
+  }
+
+  // `n` keeps its first `cnt` keys, a node type owning bytes per key releases those of the slots past them.
+  static void shrink_(node_type *n, std::size_t cnt) noexcept {
+    n->key_cnt = cnt;
+    if constexpr (requires { n->trim_(); }) n->trim_();
+  }
+
+  node_type *new_node_(bool is_leaf) {
+    count_(b_event::NODE_ALLOC);
+    node_type *n{};
+    if constexpr (requires { alloc.allocate(is_leaf); }) {
+      n = alloc.allocate(is_leaf);
+    } else {
+      n = alloc.allocate();
+    }
+    n->key_cnt = 0;
+    n->is_leaf = is_leaf;
+    if (is_leaf) n->leaf.sib = nullptr;
+    return n;
+  }
+
+  // the header and the lines the first probes of the key search land on.
+  static void prefetch_node_(const node_type *n) noexcept {
+    __builtin_prefetch(n);
+    if constexpr (requires { n->key + 0; }) {
+      __builtin_prefetch(n->key + KEY_SLOTS / 4);
+      __builtin_prefetch(n->key + KEY_SLOTS / 2);
+      __builtin_prefetch(n->key + KEY_SLOTS * 3 / 4);
+    }
+  }
+
+  void delete_node_(node_type *n) noexcept {
+    count_(b_event::NODE_FREE);
+    if (track_tail && n == tail) tail = nullptr;
+    alloc.deallocate(n);
+  }
+
+  node_type *tail_() noexcept {
+    if (!tail) {
+      node_type *cur{root};
+      while (!cur->is_leaf) {
+        cur = cur->idx.key_ptr[cur->key_cnt];
+      }
+      tail = cur;
+    }
+    return tail;
+  }
+
+  // `k` goes into `cur` without crossing a separator: it is within the leaf's keys, or past them in the last leaf.
+  bool leaf_takes_(node_type *cur, const key_type &k) const noexcept {
+    if (load_(cur) >= MAX_KEYS) return false;
+    if (cur->key_cnt == 0) return cur == root;
+    return !(k < cur->key_at_(0)) && (!cur->leaf.sib || k < cur->key_at_(cur->key_cnt - 1));
+  }
+
   bool is_overflow_(const node_type *n) noexcept {
-    return n->key_cnt >= MAX_KEYS;
+    return load_(n) >= MAX_KEYS;
   }
 
   bool root_overflow_(const node_type *root) noexcept {
-    return root->key_cnt >= MAX_KEYS;
+    return load_(root) >= MAX_KEYS;
   }
 
   bool average_2_overflow_(const node_type *a, const node_type *b) noexcept {
-    return ((a->key_cnt + b->key_cnt + 1) / 2 >= MAX_KEYS);
+    return ((load_(a) + load_(b) + 1) / 2 >= MAX_KEYS);
   }
   bool average_3_overflow_(const node_type *a, const node_type *b, const node_type *c) noexcept {
-    return ((a->key_cnt + b->key_cnt + c->key_cnt + 2) / 3) >= MAX_KEYS;
+    return ((load_(a) + load_(b) + load_(c) + 2) / 3) >= MAX_KEYS;
   }
 
   // UNUSED
@@ -120,18 +862,19 @@ private:
   }
 
   bool is_underflow_(const node_type *n) noexcept {
-    return (n->key_cnt <= MIN_KEYS);
+    return (n->key_cnt <= low_water);
   }
 
   bool root_underflow_() noexcept {
     return !root->is_leaf && root->key_cnt == 1;
   }
 
+  // by load, nodes full of bytes are not merged. `is_underflow_` stays by count, the erase paths rely on it.
   bool average_2_underflow_(const node_type *a, const node_type *b) noexcept {
-    return ((a->key_cnt + b->key_cnt) / 2) <= MIN_KEYS;
+    return ((load_(a) + load_(b)) / 2) <= MIN_KEYS;
   }
   bool average_3_underflow_(const node_type *a, const node_type *b, const node_type *c) noexcept {
-    return ((a->key_cnt + b->key_cnt + c->key_cnt) / 3) <= MIN_KEYS;
+    return ((load_(a) + load_(b) + load_(c)) / 3) <= MIN_KEYS;
   }
 
   // UNUSED
@@ -152,37 +895,44 @@ private:
   key_type redistribute_keys_(node_type *node1, node_type *node2, std::size_t need1, std::size_t need2,
                               node_type *parent, std::size_t idx1) noexcept {
 
+    count_(b_event::REDISTRIBUTE);
+    // node2 shifts all its entries, plus what crosses over when it grows.
+    std::size_t crossing{node1->key_cnt > need1 ? node1->key_cnt - need1 : 0};
+    count_(b_event::MOVED_BYTES, (node2->key_cnt + crossing) * ENTRY_BYTES);
+
     std::size_t total{node1->key_cnt + node2->key_cnt};
     if (node1->key_cnt > need1) {
       if (node1->is_leaf) {
         std::size_t key_move{node1->key_cnt - need1};
         std::size_t ptr_move{key_move};
         // adjust keys
-        std::memmove(node2->key + key_move, node2->key, node2->key_cnt * sizeof(key_type));
+        node2->move_keys_(key_move, 0, node2->key_cnt);
         // move keys
-        std::memcpy(node2->key, node1->key + need1, key_move * sizeof(key_type));
+        node2->copy_keys_(0, node1, need1, key_move);
         // adjust ptrs
-        std::memmove(node2->leaf.data_ptr + ptr_move, node2->leaf.data_ptr, node2->key_cnt * sizeof(val_type *));
+        std::memmove(node2->leaf.data + ptr_move, node2->leaf.data, node2->key_cnt * sizeof(slot_type));
         // move ptrs
-        std::memcpy(node2->leaf.data_ptr, node1->leaf.data_ptr + need1, ptr_move * sizeof(val_type *));
-        node1->key_cnt = need1;
-        node2->key_cnt = need2;
-        return node2->key[0];
+        std::memcpy(node2->leaf.data, node1->leaf.data + need1, ptr_move * sizeof(slot_type));
+        shrink_(node1, need1);
+        shrink_(node2, need2);
+        return node2->key_at_(0);
       } else {
         std::size_t key_move{node1->key_cnt - need1};
         std::size_t ptr_move{key_move};
-        key_type new_delim{node1->key[need1]};
+        key_type new_delim{node1->key_at_(need1)};
         // adjust
-        std::memmove(node2->key + key_move, node2->key, node2->key_cnt * sizeof(key_type));
+        node2->move_keys_(key_move, 0, node2->key_cnt);
         // move
-        std::memcpy(node2->key, node1->key + need1 + 1, (key_move - 1) * sizeof(key_type));
-        node2->key[key_move - 1] = parent->key[idx1];
+        node2->copy_keys_(0, node1, need1 + 1, key_move - 1);
+        node2->set_key_(key_move - 1, parent->key_at_(idx1));
         // adjust
         std::memmove(node2->idx.key_ptr + ptr_move, node2->idx.key_ptr, (node2->key_cnt + 1) * sizeof(node_type *));
+        move_sums_(node2, ptr_move, node2, 0, node2->key_cnt + 1);
         // move
         std::memcpy(node2->idx.key_ptr, node1->idx.key_ptr + need1 + 1, ptr_move * sizeof(node_type *));
-        node1->key_cnt = need1;
-        node2->key_cnt = need2;
+        move_sums_(node2, 0, node1, need1 + 1, ptr_move);
+        shrink_(node1, need1);
+        shrink_(node2, need2);
         return new_delim;
       }
     } else if (node1->key_cnt < need1) {
@@ -190,84 +940,98 @@ private:
         std::size_t key_move{need1 - node1->key_cnt};
         std::size_t ptr_move{key_move};
         // move
-        std::memcpy(node1->key + node1->key_cnt, node2->key, (key_move) * sizeof(key_type));
+        node1->copy_keys_(node1->key_cnt, node2, 0, key_move);
         // adjust
-        std::memmove(node2->key, node2->key + key_move, (node2->key_cnt - key_move) * sizeof(key_type));
+        node2->move_keys_(0, key_move, node2->key_cnt - key_move);
         // move
-        std::memcpy(node1->leaf.data_ptr + node1->key_cnt, node2->leaf.data_ptr, (ptr_move) * sizeof(val_type *));
+        std::memcpy(node1->leaf.data + node1->key_cnt, node2->leaf.data, (ptr_move) * sizeof(slot_type));
         // adjust
-        std::memmove(node2->leaf.data_ptr, node2->leaf.data_ptr + ptr_move,
-                     (node2->key_cnt - ptr_move) * sizeof(val_type *));
-        node1->key_cnt = need1;
-        node2->key_cnt = need2;
-        return node2->key[0];
+        std::memmove(node2->leaf.data, node2->leaf.data + ptr_move,
+                     (node2->key_cnt - ptr_move) * sizeof(slot_type));
+        shrink_(node1, need1);
+        shrink_(node2, need2);
+        return node2->key_at_(0);
       } else {
         std::size_t key_move{need1 - node1->key_cnt};
         std::size_t ptr_move{key_move};
-        key_type new_delim{node2->key[node2->key_cnt - need2 - 1]};
+        key_type new_delim{node2->key_at_(node2->key_cnt - need2 - 1)};
         // move
-        node1->key[node1->key_cnt] = parent->key[idx1];
-        std::memcpy(node1->key + node1->key_cnt + 1, node2->key, (key_move - 1) * sizeof(key_type));
+        node1->set_key_(node1->key_cnt, parent->key_at_(idx1));
+        node1->copy_keys_(node1->key_cnt + 1, node2, 0, key_move - 1);
         // adjust
-        std::memmove(node2->key, node2->key + key_move,
-                     (node2->key_cnt - key_move) * sizeof(key_type)); // BUG
+        node2->move_keys_(0, key_move, node2->key_cnt - key_move); // BUG
         // move
         std::memcpy(node1->idx.key_ptr + node1->key_cnt + 1, node2->idx.key_ptr,
                     ptr_move * sizeof(node_type *)); // ?
+        move_sums_(node1, node1->key_cnt + 1, node2, 0, ptr_move);
         // adjust
         std::memmove(node2->idx.key_ptr, node2->idx.key_ptr + ptr_move,
                      (node2->key_cnt + 1 - ptr_move) * sizeof(node_type *));
-        node1->key_cnt = need1;
-        node2->key_cnt = need2;
+        move_sums_(node2, 0, node2, ptr_move, node2->key_cnt + 1 - ptr_move);
+        shrink_(node1, need1);
+        shrink_(node2, need2);
         return new_delim;
       }
     }
 
     // nothing should be changed.
-    return parent->key[idx1];
+    return parent->key_at_(idx1);
   }
 
   void new_key_in_parent_(node_type *node1, node_type *node2, node_type *parent, std::size_t idx1) noexcept {
-    std::memmove(parent->key + idx1 + 1, parent->key + idx1, (parent->key_cnt - idx1) * sizeof(key_type));
+    count_(b_event::MOVED_BYTES, (parent->key_cnt - idx1) * ENTRY_BYTES);
+    parent->move_keys_(idx1 + 1, idx1, parent->key_cnt - idx1);
     std::memmove(parent->idx.key_ptr + idx1 + 2, parent->idx.key_ptr + idx1 + 1,
                  (parent->key_cnt - idx1) * sizeof(node_type *));
+    move_sums_(parent, idx1 + 2, parent, idx1 + 1, parent->key_cnt - idx1);
     // trick
     if (!node1->is_leaf) {
       node2->idx.key_ptr[0] = node1->idx.key_ptr[node1->key_cnt];
-      parent->key[idx1] = node1->key[--node1->key_cnt];
+      move_sums_(node2, 0, node1, node1->key_cnt, 1);
+      parent->set_key_(idx1, node1->key_at_(node1->key_cnt - 1));
+      shrink_(node1, node1->key_cnt - 1);
     }
     parent->idx.key_ptr[idx1] = node1;
     parent->idx.key_ptr[idx1 + 1] = node2;
     parent->key_cnt++;
+    refresh_sum_(parent, idx1);
+    refresh_sum_(parent, idx1 + 1);
   }
 
   void modify_key_in_parent_(node_type *node1, node_type *node2, node_type *parent, std::size_t idx1,
                              const key_type &new_key) noexcept {
     if (node1->is_leaf) {
-      parent->key[idx1] = node2->key[0];
+      parent->set_key_(idx1, node_type::separator_(node1, node2));
     } else {
-      parent->key[idx1] = new_key;
+      parent->set_key_(idx1, new_key);
     }
     parent->idx.key_ptr[idx1] = node1;
     parent->idx.key_ptr[idx1 + 1] = node2;
+    refresh_sum_(parent, idx1);
+    refresh_sum_(parent, idx1 + 1);
   }
 
   void delete_key_in_parent_(node_type *node1, node_type *node2, node_type *parent, std::size_t idx1) noexcept {
     // trick
     if (!node1->is_leaf) {
-      node1->key[node1->key_cnt++] = parent->key[idx1];
+      node1->set_key_(node1->key_cnt++, parent->key_at_(idx1));
       node1->idx.key_ptr[node1->key_cnt] = node2->idx.key_ptr[0];
+      move_sums_(node1, node1->key_cnt, node2, 0, 1);
     }
     // ???
-    std::memmove(parent->key + idx1, parent->key + idx1 + 1, (parent->key_cnt - (idx1 + 1)) * sizeof(key_type));
+    count_(b_event::MOVED_BYTES, (parent->key_cnt - (idx1 + 1)) * ENTRY_BYTES);
+    parent->move_keys_(idx1, idx1 + 1, parent->key_cnt - (idx1 + 1));
     std::memmove(parent->idx.key_ptr + idx1 + 1, parent->idx.key_ptr + idx1 + 2,
                  (parent->key_cnt - (idx1 + 1)) * sizeof(node_type *));
-    parent->key_cnt--;
+    move_sums_(parent, idx1 + 1, parent, idx1 + 2, parent->key_cnt - (idx1 + 1));
+    shrink_(parent, parent->key_cnt - 1);
+    refresh_sum_(parent, idx1);
   }
 
   void link_split_leaf(node_type *node1, node_type *new_node) {
     new_node->leaf.sib = node1->leaf.sib;
     node1->leaf.sib = new_node;
+    if (track_tail && node1 == tail) tail = new_node;
   }
 
   void link_merge_leaf(node_type *node1, node_type *delete_node) {
@@ -275,9 +1039,8 @@ private:
   }
 
   void do_1_2_split_(node_type *node1, node_type *parent, std::size_t idx1) noexcept {
-    node_type *node2{new node_type{}};
-    node2->key_cnt = 0;
-    node2->is_leaf = root->is_leaf;
+    count_(b_event::SPLIT_1_2);
+    node_type *node2{new_node_(node1->is_leaf)};
 
     if (node1->is_leaf) {
       link_split_leaf(node1, node2);
@@ -293,7 +1056,26 @@ private:
     modify_key_in_parent_(node1, node2, parent, 0, new_key);
   }
 
+  // the last leaf is full and `k` goes past it: the new leaf takes only its last key,
+  // so ascending inserts leave full leaves behind instead of the 2/3 of a 2-3 split.
+  void do_append_split_(node_type *node1, node_type *parent, std::size_t idx1) noexcept {
+    count_(b_event::SPLIT_1_2);
+    node_type *node2{new_node_(true)};
+    link_split_leaf(node1, node2);
+    new_key_in_parent_(node1, node2, parent, idx1);
+    count_(b_event::MOVED_BYTES, ENTRY_BYTES);
+    std::size_t last{node1->key_cnt - 1};
+    node2->copy_keys_(0, node1, last, 1);
+    node2->leaf.data[0] = node1->leaf.data[last];
+    shrink_(node1, last);
+    node2->key_cnt = 1;
+    parent->set_key_(idx1, node_type::separator_(node1, node2));
+    refresh_sum_(parent, idx1);
+    refresh_sum_(parent, idx1 + 1);
+  }
+
   void do_2_1_merge_(node_type *node1, node_type *node2, node_type *parent, std::size_t idx1) noexcept {
+    count_(b_event::MERGE_2_1);
     std::size_t total{node1->key_cnt + node2->key_cnt};
     key_type new_key{redistribute_keys_(node1, node2, total, 0, parent, idx1)};
     modify_key_in_parent_(node1, node2, parent, idx1, new_key);
@@ -303,15 +1085,14 @@ private:
       link_merge_leaf(node1, node2);
     }
 
-    delete node2;
+    delete_node_(node2);
   }
 
   // PASSED FAST_TEST
   void do_2_3_split_(node_type *node1, node_type *node2, node_type *parent, std::size_t idx1,
                      std::size_t idx2) noexcept {
-    node_type *node3{new node_type{}};
-    node3->key_cnt = 0;
-    node3->is_leaf = node1->is_leaf;
+    count_(b_event::SPLIT_2_3);
+    node_type *node3{new_node_(node1->is_leaf)};
 
     new_key_in_parent_(node2, node3, parent, idx2);
     if (node1->is_leaf) {
@@ -323,8 +1104,15 @@ private:
     std::size_t need2{(total + 1) / 3};
     std::size_t need3{total / 3};
 
-    key_type new_key2{redistribute_keys_(node2, node3, node2->key_cnt - need3, need3, parent, idx2)};
-    key_type new_key1{redistribute_keys_(node1, node2, need1, need2, parent, idx1)};
+    key_type new_key1{}, new_key2{};
+    if (node2->key_cnt >= need3) {
+      new_key2 = redistribute_keys_(node2, node3, node2->key_cnt - need3, need3, parent, idx2);
+      new_key1 = redistribute_keys_(node1, node2, need1, need2, parent, idx1);
+    } else {
+      // a short node2, left under `MIN_KEYS` by erases, is filled from node1 before it feeds node3.
+      new_key1 = redistribute_keys_(node1, node2, need1, total - need1, parent, idx1);
+      new_key2 = redistribute_keys_(node2, node3, need2, need3, parent, idx2);
+    }
     modify_key_in_parent_(node2, node3, parent, idx2, new_key2);
     modify_key_in_parent_(node1, node2, parent, idx1, new_key1);
   }
@@ -332,10 +1120,17 @@ private:
   // PASSED FAST_TEST
   void do_3_2_merge_(node_type *node1, node_type *node2, node_type *node3, node_type *parent, std::size_t idx1,
                      std::size_t idx2, std::size_t idx3) noexcept {
+    count_(b_event::MERGE_3_2);
     std::size_t total{node1->key_cnt + node2->key_cnt + node3->key_cnt};
     std::size_t need1{(total + 1) / 2};
     std::size_t need2{total / 2};
 
+    // nodes left under `MIN_KEYS` by a lower `low_water` may hold less than node1 needs, node3 passes some on first.
+    if (node1->key_cnt + node2->key_cnt < need1) {
+      std::size_t need{need1 - node1->key_cnt + 1};
+      key_type new_key{redistribute_keys_(node2, node3, need, node2->key_cnt + node3->key_cnt - need, parent, idx2)};
+      modify_key_in_parent_(node2, node3, parent, idx2, new_key);
+    }
     key_type new_key1{redistribute_keys_(node1, node2, need1, node1->key_cnt + node2->key_cnt - need1, parent, idx1)};
     key_type new_key2{redistribute_keys_(node2, node3, need2, 0, parent, idx2)};
     modify_key_in_parent_(node1, node2, parent, idx1, new_key1);
@@ -346,11 +1141,12 @@ private:
       link_merge_leaf(node2, node3);
     }
 
-    delete node3;
+    delete_node_(node3);
   }
 
   // PASSED FAST_TEST
   void do_2_equal_split_(node_type *node1, node_type *node2, node_type *parent, std::size_t idx1) noexcept {
+    count_(b_event::EQUAL_SPLIT_2);
     std::size_t total{node1->key_cnt + node2->key_cnt};
     std::size_t need1{(total + 1) / 2};
     std::size_t need2{total / 2};
@@ -361,6 +1157,7 @@ private:
 
   void do_3_equal_split_(node_type *node1, node_type *node2, node_type *node3, node_type *parent, std::size_t idx1,
                          std::size_t idx2) noexcept {
+    count_(b_event::EQUAL_SPLIT_3);
     std::size_t total{node1->key_cnt + node2->key_cnt + node3->key_cnt};
     std::size_t need1{(total + 2) / 3};
     std::size_t need2{(total + 1) / 3};
@@ -454,9 +1251,8 @@ private:
   }
 
   void fix_root_overflow_() {
-    node_type *new_root{new node_type{}};
-    new_root->key_cnt = 0;
-    new_root->is_leaf = false;
+    count_(b_event::ROOT_OVERFLOW);
+    node_type *new_root{new_node_(false)};
 
     do_1_2_split_(root, new_root, 0);
 
@@ -495,7 +1291,8 @@ private:
       return;
     }
 
-    if (!average_3_overflow_(node1, node2, node3) && !average_3_underflow_(node1, node2, node3)) {
+    // three nodes heavy by load alone still hold too many keys for two.
+    if (!average_3_underflow_(node1, node2, node3)) {
       do_3_equal_split_(node1, node2, node3, parent, idx1, idx2);
       return;
     }
@@ -504,12 +1301,13 @@ private:
   }
 
   void fix_root_underflow_() {
+    count_(b_event::ROOT_UNDERFLOW);
     node_type *node1{root->idx.key_ptr[0]};
     node_type *node2{root->idx.key_ptr[1]};
     if ((node1->is_leaf && node1->key_cnt + node2->key_cnt <= MAX_KEYS) ||
         (!node1->is_leaf && node1->key_cnt + node2->key_cnt < MAX_KEYS)) {
       do_2_1_merge_(node1, node2, root, 0);
-      delete root;
+      delete_node_(root);
       root = node1;
     } else {
       do_2_equal_split_(node1, node2, root, 0);
@@ -517,14 +1315,13 @@ private:
     return;
   }
 
-  void delete_all_nodes_(bool del_root) {
-    if (root) {
-      std::vector<node_type *> decon{};
-      if (!root->is_leaf) {
-        for (std::size_t i = 0; i <= root->key_cnt; i++) {
-          decon.emplace_back(root->idx.key_ptr[i]);
-        }
-      }
+  // every node under `top`, all of them from `from`.
+  static void free_nodes_(alloc_type &from, node_type *top) {
+    if constexpr (requires { from.release(); }) {
+      // every node lives in the arena, drop the slabs.
+      from.release();
+    } else {
+      std::vector<node_type *> decon{top};
       while (!decon.empty()) {
         node_type *cur{decon.back()};
         decon.pop_back();
@@ -533,76 +1330,660 @@ private:
             decon.emplace_back(cur->idx.key_ptr[i]);
           }
         }
-        delete cur;
-      }
-      if (del_root) {
-        delete root; // and root
+        count_(b_event::NODE_FREE);
+        from.deallocate(cur);
       }
     }
   }
 
-public:
-  b_star_tree() noexcept {
-    root = new node_type{};
-    root->key_cnt = 0;
-    root->is_leaf = true;
+  void delete_all_nodes_() {
+    tail = nullptr;
+    if (!root) return;
+    free_nodes_(alloc, root);
+    root = nullptr;
   }
-  ~b_star_tree() {
-    delete_all_nodes_(true);
+
+  static node_type *leftmost_(node_type *cur) noexcept {
+    while (!cur->is_leaf) {
+      cur = cur->idx.key_ptr[0];
+    }
+    return cur;
   }
 
-  b_star_tree(const b_star_tree &obj) = delete;
-  b_star_tree(b_star_tree &&obj) noexcept {
-    delete_all_nodes_(true);
-    root = obj.root;
-    obj.root = nullptr;
+  // drops [from, to) of a leaf.
+  void erase_leaf_run_(node_type *cur, std::size_t from, std::size_t to) noexcept {
+    count_(b_event::MOVED_BYTES, (cur->key_cnt - to) * ENTRY_BYTES);
+    std::memmove(cur->leaf.data + from, cur->leaf.data + to, (cur->key_cnt - to) * sizeof(slot_type));
+    cur->move_keys_(from, to, cur->key_cnt - to);
+    shrink_(cur, cur->key_cnt - (to - from));
   }
 
-  b_star_tree &operator=(const b_star_tree &obj) = delete;
-  b_star_tree &operator=(b_star_tree &&obj) noexcept {
-    delete_all_nodes_(true);
-    root = obj.root;
-    obj.root = nullptr;
-    return *this;
+  // frees `top` and everything under it, returns how many keys its leaves held.
+  std::size_t drop_subtree_(node_type *top) noexcept {
+    std::size_t keys{0};
+    if (top->is_leaf) {
+      keys = top->key_cnt;
+    } else {
+      for (std::size_t i = 0; i <= top->key_cnt; i++) {
+        keys += drop_subtree_(top->idx.key_ptr[i]);
+      }
+    }
+    delete_node_(top);
+    return keys;
+  }
+
+  // cuts [low, high) out of the subtree under `cur`, a null bound leaves that side open. the children between the
+  // two holding the bounds go whole, those two are cut in turn. nothing is rebalanced, returns how many keys went.
+  std::size_t cut_range_(node_type *cur, const key_type *low, const key_type *high) noexcept {
+    if (cur->is_leaf) {
+      std::size_t from{low ? cur->find_data_ptr_index_(*low) : 0};
+      std::size_t to{high ? cur->find_data_ptr_index_(*high) : cur->key_cnt};
+      if (from >= to) return 0;
+      erase_leaf_run_(cur, from, to);
+      return to - from;
+    }
+    std::size_t a{low ? cur->find_data_ptr_index_(*low) : 0};
+    std::size_t b{high ? cur->find_data_ptr_index_(*high) : cur->key_cnt};
+    if (a == b) {
+      std::size_t erased{cut_range_(cur->idx.key_ptr[a], low, high)};
+      refresh_sum_(cur, a);
+      return erased;
+    }
+
+    // children [from, to) go, with the keys between them. a kept child on the left keeps the separator on the right.
+    std::size_t from{low ? a + 1 : a}, to{high ? b : b + 1}, erased{0};
+    if (from < to) {
+      for (std::size_t i = from; i < to; i++) {
+        erased += drop_subtree_(cur->idx.key_ptr[i]);
+      }
+      std::size_t keys_from{from > 0 ? from - 1 : 0};
+      count_(b_event::MOVED_BYTES, (cur->key_cnt - (keys_from + to - from)) * ENTRY_BYTES);
+      cur->move_keys_(keys_from, keys_from + to - from, cur->key_cnt - (keys_from + to - from));
+      std::memmove(cur->idx.key_ptr + from, cur->idx.key_ptr + to, (cur->key_cnt + 1 - to) * sizeof(node_type *));
+      move_sums_(cur, from, cur, to, cur->key_cnt + 1 - to);
+      shrink_(cur, cur->key_cnt - (to - from));
+    }
+
+    if (low) {
+      erased += cut_range_(cur->idx.key_ptr[a], low, nullptr);
+      refresh_sum_(cur, a);
+    }
+    if (high) {
+      erased += cut_range_(cur->idx.key_ptr[from], nullptr, high);
+      refresh_sum_(cur, from);
+    }
+    return erased;
+  }
+
+  // after a cut, root down to where `k` goes: a short child merges into a neighbor when both fit in one node,
+  // otherwise the two are evened out. a node merged down to one child is fixed from its parent, starting over.
+  void repair_path_(const key_type &k) noexcept {
+    bool again{true};
+    while (again) {
+      again = false;
+      while (!root->is_leaf && root->key_cnt == 0) {
+        node_type *old{root};
+        root = root->idx.key_ptr[0];
+        delete_node_(old);
+      }
+      node_type *cur{root};
+      while (!cur->is_leaf) {
+        std::size_t i{cur->find_data_ptr_index_(k)};
+        while (cur->key_cnt > 0 && is_underflow_(cur->idx.key_ptr[i])) {
+          std::size_t idx1{i > 0 ? i - 1 : 0};
+          node_type *node1{cur->idx.key_ptr[idx1]}, *node2{cur->idx.key_ptr[idx1 + 1]};
+          if (node1->key_cnt + node2->key_cnt + !node1->is_leaf > MAX_KEYS) {
+            do_2_equal_split_(node1, node2, cur, idx1);
+            break;
+          }
+          do_2_1_merge_(node1, node2, cur, idx1);
+          i = idx1;
+        }
+        if (cur->key_cnt == 0) {
+          again = true;
+          break;
+        }
+        cur = cur->idx.key_ptr[cur->find_data_ptr_index_(k)];
+      }
+    }
+  }
+
+  // bottom up, every child of `cur` over `MIN_KEYS` keys where its siblings allow it.
+  // moving children between index nodes keeps them as they are, so each level is fixed once.
+  void rebalance_(node_type *cur) noexcept {
+    if (!cur->idx.key_ptr[0]->is_leaf) {
+      for (std::size_t i = 0; i <= cur->key_cnt; i++) {
+        rebalance_(cur->idx.key_ptr[i]);
+      }
+    }
+    std::size_t i{0};
+    while (i <= cur->key_cnt) {
+      if (cur->idx.key_ptr[i]->key_cnt > MIN_KEYS) {
+        i++;
+        continue;
+      }
+      std::size_t cnt{cur->key_cnt};
+      fix_underflow_(cur->idx.key_ptr[i], cur, i);
+      // a merge may leave the two on the left still short, otherwise the child is done or cannot be helped.
+      i = cur->key_cnt < cnt ? i - std::min<std::size_t>(i, 2) : i + 1;
+    }
+  }
+
+  // (key, slot) of every leaf entry from a leaf on, the input `compact()` hands to `build_from_sorted_()`.
+  struct leaf_entries_ {
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::pair<key_ref, slot_type>;
+    using reference = value_type;
+
+    const node_type *cur{};
+    std::size_t pos{};
+
+    void skip_empty_() noexcept {
+      while (cur && pos == cur->key_cnt) {
+        cur = cur->leaf.sib;
+        pos = 0;
+      }
+    }
+
+    reference operator*() const noexcept {
+      return {cur->key_at_(pos), cur->leaf.data[pos]};
+    }
+    leaf_entries_ &operator++() noexcept {
+      pos++;
+      skip_empty_();
+      return *this;
+    }
+    leaf_entries_ operator++(int) noexcept {
+      leaf_entries_ old{*this};
+      ++*this;
+      return old;
+    }
+    bool operator==(const leaf_entries_ &) const noexcept = default;
+  };
+
+  // where the next `compact_step()` starts, none for the leftmost leaf.
+  std::optional<key_type> compact_from{};
+  std::vector<std::pair<key_type, slot_type>> compact_buf{};
+
+  // repacks the leaves under `parent`, the index node right above them, into as few as `target` keys each allows,
+  // reusing the leftmost ones in place. `parent` keeps two children at least and is never given more than it has,
+  // it may be left under `low_water` for the caller to fix from above.
+  void repack_leaves_(node_type *parent, std::size_t target) {
+    std::size_t cnt{parent->key_cnt + 1}, total{0};
+    for (std::size_t i = 0; i < cnt; i++) {
+      total += parent->idx.key_ptr[i]->key_cnt;
+    }
+    std::size_t want{std::max((total + target - 1) / target, (total + MAX_KEYS - 1) / MAX_KEYS)};
+    want = std::clamp<std::size_t>(want, std::min<std::size_t>(2, cnt), cnt);
+    if (want == cnt) return;
+
+    compact_buf.clear();
+    for (std::size_t i = 0; i < cnt; i++) {
+      node_type *leaf{parent->idx.key_ptr[i]};
+      for (std::size_t j = 0; j < leaf->key_cnt; j++) {
+        compact_buf.emplace_back(key_type(leaf->key_at_(j)), leaf->leaf.data[j]);
+      }
+    }
+    node_type *after{parent->idx.key_ptr[cnt - 1]->leaf.sib};
+    for (std::size_t i = want; i < cnt; i++) {
+      delete_node_(parent->idx.key_ptr[i]);
+    }
+
+    std::size_t from{0};
+    for (std::size_t i = 0; i < want; i++) {
+      node_type *leaf{parent->idx.key_ptr[i]};
+      std::size_t share{pack_share_(total, want, i)};
+      for (std::size_t j = 0; j < share; j++) {
+        leaf->set_key_(j, compact_buf[from + j].first);
+        leaf->leaf.data[j] = compact_buf[from + j].second;
+      }
+      count_(b_event::MOVED_BYTES, share * ENTRY_BYTES);
+      shrink_(leaf, share);
+      leaf->leaf.sib = i + 1 < want ? parent->idx.key_ptr[i + 1] : after;
+      if (i > 0) parent->set_key_(i - 1, node_type::separator_(parent->idx.key_ptr[i - 1], leaf));
+      refresh_sum_(parent, i);
+      from += share;
+    }
+    shrink_(parent, want - 1);
+  }
+
+  // number of nodes to spread `items` over, each node wants `target` items and must stay in [lo, hi].
+  static std::size_t pack_count_(std::size_t items, std::size_t target, std::size_t lo, std::size_t hi) noexcept {
+    std::size_t cnt{(items + target - 1) / target};
+    std::size_t most{items / lo}, least{(items + hi - 1) / hi};
+    cnt = std::min(cnt, std::max<std::size_t>(most, 1));
+    return std::max(cnt, least);
+  }
+
+  // `items` of the level below spread over `cnt` nodes, the i-th node takes the returned amount.
+  static std::size_t pack_share_(std::size_t items, std::size_t cnt, std::size_t i) noexcept {
+    return items / cnt + (i < items % cnt ? 1 : 0);
+  }
+
+  // leaves are filled left to right, then every index level is built on top of the previous one.
+  // `unique` skips repeated keys, `n` counts what is kept.
+  template<typename iter>
+  void build_from_sorted_(iter first, iter last, std::size_t n, double fill_factor, bool unique = true) {
+    std::size_t target{static_cast<std::size_t>(fill_factor * static_cast<double>(MAX_KEYS) + 0.5)};
+    target = std::clamp(target, MIN_KEYS + 1, MAX_KEYS);
+
+    std::size_t leaf_cnt{pack_count_(n, target, MIN_KEYS + 1, MAX_KEYS)};
+    std::vector<node_type *> level{};
+    std::vector<key_type> low{};
+    level.reserve(leaf_cnt);
+    low.reserve(leaf_cnt);
+
+    node_type *prev{};
+    while (!node_type::key_fits_(std::get<0>(*first))) {
+      ++first;
+    }
+    for (std::size_t i = 0; i < leaf_cnt; i++) {
+      node_type *cur{new_node_(true)};
+      std::size_t share{pack_share_(n, leaf_cnt, i)};
+      for (std::size_t j = 0; j < share; j++) {
+        cur->set_key_(j, std::get<0>(*first));
+        cur->leaf.data[j] = std::get<1>(*first);
+        // skip the duplicates, first one wins like `insert()`, and the keys `insert()` would refuse.
+        do {
+          ++first;
+        } while (first != last && ((unique && !(cur->key_at_(j) < std::get<0>(*first))) ||
+                                   !node_type::key_fits_(std::get<0>(*first))));
+      }
+      cur->key_cnt = share;
+      if (prev) {
+        prev->leaf.sib = cur;
+        low.emplace_back(node_type::separator_(prev, cur));
+      } else {
+        low.emplace_back(cur->key_at_(0));
+      }
+      prev = cur;
+      level.emplace_back(cur);
+    }
+
+    build_index_(level, low, target, 1);
+  }
+
+  // the first item of the i-th of `cnt` nodes sharing `items`, the sum of the shares before it.
+  static std::size_t pack_start_(std::size_t items, std::size_t cnt, std::size_t i) noexcept {
+    return i * (items / cnt) + std::min(i, items % cnt);
+  }
+
+  // index levels on top of `level`, `low[i]` being the smallest key under `level[i]`, up to the root.
+  // nodes are allocated here, `threads` only fill them.
+  void build_index_(std::vector<node_type *> &level, std::vector<key_type> &low, std::size_t target,
+                    std::size_t threads) {
+    std::vector<node_type *> up{};
+    std::vector<key_type> up_low{};
+    while (level.size() > 1) {
+      std::size_t items{level.size()};
+      std::size_t cnt{pack_count_(items, target + 1, MIN_KEYS + 2, MAX_KEYS + 1)};
+      up.resize(cnt);
+      up_low.resize(cnt);
+      for (std::size_t i = 0; i < cnt; i++) {
+        up[i] = new_node_(false);
+      }
+      parallel_for_(threads, cnt, [&](std::size_t i) {
+        node_type *cur{up[i]};
+        std::size_t from{pack_start_(items, cnt, i)}, share{pack_share_(items, cnt, i)};
+        for (std::size_t j = 0; j < share; j++) {
+          cur->idx.key_ptr[j] = level[from + j];
+          refresh_sum_(cur, j);
+          if (j > 0) cur->set_key_(j - 1, low[from + j]);
+        }
+        cur->key_cnt = share - 1;
+        up_low[i] = low[from];
+      });
+      level.swap(up);
+      low.swap(up_low);
+    }
+    root = level[0];
+  }
+
+  // `build_from_sorted_()` over `threads` threads, the input sorted first unless `sorted`. the input is cut in
+  // chunks, each counting the entries it keeps; a chunk then fills the leaves starting among its entries, reading
+  // on into the next chunk for the last one, so leaves come out exactly as the serial build makes them.
+  template<std::random_access_iterator iter>
+  void build_parallel_(iter first, iter last, std::size_t threads, double fill_factor, bool sorted, bool unique) {
+    delete_all_nodes_();
+    threads = std::max<std::size_t>(threads, 1);
+    std::size_t total{static_cast<std::size_t>(last - first)};
+    auto less = [](const auto &a, const auto &b) { return std::get<0>(a) < std::get<0>(b); };
+    if (!sorted) {
+      // sorted runs, merged pairwise. stable so that the first of equal keys still wins.
+      std::size_t runs{std::min(threads, std::max<std::size_t>(total / 4096, 1))};
+      parallel_for_(threads, runs, [&](std::size_t r) {
+        std::stable_sort(first + pack_start_(total, runs, r), first + pack_start_(total, runs, r + 1), less);
+      });
+      for (std::size_t width = 1; width < runs; width *= 2) {
+        parallel_for_(threads, (runs + 2 * width - 1) / (2 * width), [&](std::size_t p) {
+          std::size_t a{2 * width * p};
+          if (a + width >= runs) return;
+          std::inplace_merge(first + pack_start_(total, runs, a), first + pack_start_(total, runs, a + width),
+                             first + pack_start_(total, runs, std::min(a + 2 * width, runs)), less);
+        });
+      }
+    }
+
+    auto kept = [&](iter it) {
+      return node_type::key_fits_(std::get<0>(*it)) && (!unique || it == first || less(*(it - 1), *it));
+    };
+    std::size_t chunks{std::min(4 * threads, std::max<std::size_t>(total, 1))};
+    std::vector<std::size_t> before(chunks + 1);
+    parallel_for_(threads, chunks, [&](std::size_t c) {
+      std::size_t cnt{0};
+      for (iter it = first + pack_start_(total, chunks, c); it != first + pack_start_(total, chunks, c + 1); ++it) {
+        cnt += kept(it);
+      }
+      before[c + 1] = cnt;
+    });
+    std::partial_sum(before.begin(), before.end(), before.begin());
+    std::size_t n{before[chunks]};
+    if (n == 0) {
+      root = new_node_(true);
+      return;
+    }
+
+    std::size_t target{static_cast<std::size_t>(fill_factor * static_cast<double>(MAX_KEYS) + 0.5)};
+    target = std::clamp(target, MIN_KEYS + 1, MAX_KEYS);
+    std::size_t leaf_cnt{pack_count_(n, target, MIN_KEYS + 1, MAX_KEYS)};
+    std::vector<node_type *> level(leaf_cnt);
+    std::vector<key_type> low(leaf_cnt);
+    for (std::size_t i = 0; i < leaf_cnt; i++) {
+      level[i] = new_node_(true);
+    }
+    // the first leaf starting at or after kept entry `k`.
+    auto leaf_at = [&](std::size_t k) {
+      std::size_t lo{0}, hi{leaf_cnt};
+      while (lo < hi) {
+        std::size_t mid{(lo + hi) / 2};
+        if (pack_start_(n, leaf_cnt, mid) < k) lo = mid + 1;
+        else hi = mid;
+      }
+      return lo;
+    };
+    parallel_for_(threads, chunks, [&](std::size_t c) {
+      std::size_t from{leaf_at(before[c])}, to{leaf_at(before[c + 1])};
+      if (from == to) return;
+      iter it{first + pack_start_(total, chunks, c)};
+      for (std::size_t skip = pack_start_(n, leaf_cnt, from) - before[c]; skip > 0; ++it) {
+        skip -= kept(it);
+      }
+      for (std::size_t i = from; i < to; i++) {
+        node_type *cur{level[i]};
+        std::size_t share{pack_share_(n, leaf_cnt, i)};
+        for (std::size_t j = 0; j < share; j++, ++it) {
+          while (!kept(it)) {
+            ++it;
+          }
+          cur->set_key_(j, std::get<0>(*it));
+          cur->leaf.data[j] = std::get<1>(*it);
+        }
+        cur->key_cnt = share;
+      }
+    });
+    parallel_for_(threads, chunks, [&](std::size_t c) {
+      for (std::size_t i = pack_start_(leaf_cnt, chunks, c); i < pack_start_(leaf_cnt, chunks, c + 1); i++) {
+        if (i + 1 < leaf_cnt) level[i]->leaf.sib = level[i + 1];
+        low[i] = i > 0 ? key_type(node_type::separator_(level[i - 1], level[i])) : key_type(level[i]->key_at_(0));
+      }
+    });
+    build_index_(level, low, target, threads);
+  }
+
+public:
+  b_star_tree() {
+    root = new_node_(true);
+  }
+
+  // same as `bulk_load()` on an empty tree.
+  template<std::forward_iterator iter>
+  b_star_tree(iter first, iter last, double fill_factor = 1.0) {
+    bulk_load(first, last, fill_factor);
+  }
+  ~b_star_tree() {
+    delete_all_nodes_();
+  }
+
+  b_star_tree(const b_star_tree &obj) = delete;
+  // the policy fields move along, `compact_step()` goes on where it stopped.
+  b_star_tree(b_star_tree &&obj) noexcept
+      : alloc{std::move(obj.alloc)}, track_tail{obj.track_tail}, low_water{obj.low_water},
+        compact_from{std::exchange(obj.compact_from, std::nullopt)} {
+    root = std::exchange(obj.root, nullptr);
+    tail = std::exchange(obj.tail, nullptr);
+  }
+
+  b_star_tree &operator=(const b_star_tree &obj) = delete;
+  b_star_tree &operator=(b_star_tree &&obj) noexcept {
+    if (this != &obj) {
+      delete_all_nodes_();
+      alloc = std::move(obj.alloc);
+      root = std::exchange(obj.root, nullptr);
+      tail = std::exchange(obj.tail, nullptr);
+      track_tail = obj.track_tail;
+      low_water = obj.low_water;
+      compact_from = std::exchange(obj.compact_from, std::nullopt);
+    }
+    return *this;
   }
 
   void clear() {
-    delete_all_nodes_(false);
+    delete_all_nodes_();
+    root = new_node_(true);
+  }
+
+  // replaces the content with `[first, last)` of (key, slot) pairs sorted by key.
+  // each node ends up with `fill_factor * MAX_KEYS` keys, kept inside [MIN_KEYS, MAX_KEYS] when possible.
+  template<std::forward_iterator iter>
+  void bulk_load(iter first, iter last, double fill_factor = 1.0) {
+    delete_all_nodes_();
+    std::size_t n{0};
+    iter kept{last};
+    for (iter it = first; it != last; ++it) {
+      if (!node_type::key_fits_(std::get<0>(*it))) continue;
+      if (kept == last || std::get<0>(*kept) < std::get<0>(*it)) n++;
+      kept = it;
+    }
+    if (n == 0) {
+      root = new_node_(true);
+      return;
+    }
+    build_from_sorted_(first, last, n, fill_factor);
+  }
+
+  // `bulk_load()` built by `threads` threads, from input in any order unless `sorted`, stable-sorted in place first.
+  template<std::random_access_iterator iter>
+  void bulk_load_parallel(iter first, iter last, std::size_t threads, double fill_factor = 1.0, bool sorted = false) {
+    build_parallel_(first, last, threads, fill_factor, sorted, true);
   }
 
-  node_type *insert_down_to_leaf(node_type *root, const key_type &k) noexcept {
+  // a separator as (index node, key index), `node == nullptr` stands for +inf.
+  struct bound {
+    const node_type *node{};
+    std::size_t i{};
+
+    bool above(const key_type &k) const {
+      return !node || k < node->key_at_(i);
+    }
+  };
+
+  // the index nodes a descent went through, root first, and the child it took in each.
+  struct descent {
+    node_type *node[64];
+    std::size_t at[64];
+    std::size_t depth{};
+  };
+
+  // rebuilds the tree from its own leaves into nodes allocated one after the other from a fresh allocator,
+  // so the leaves lie in key order in memory with `target_fill * MAX_KEYS` keys each, then frees the old nodes.
+  // needs room for both trees meanwhile.
+  void compact(double target_fill = 1.0)
+    requires std::is_move_constructible_v<alloc_type> && std::is_move_assignable_v<alloc_type>
+  {
+    std::size_t n{0};
+    for (node_type *cur = leftmost_(root); cur; cur = cur->leaf.sib) {
+      n += cur->key_cnt;
+    }
+    node_type *old_root{root};
+    tail = nullptr;
+    alloc_type old_alloc{std::move(alloc)};
+    alloc = alloc_type{};
+    if (n == 0) {
+      root = new_node_(true);
+    } else {
+      leaf_entries_ first{leftmost_(old_root), 0};
+      first.skip_empty_();
+      // the keys are in order already, and a multitree keeps its duplicates.
+      build_from_sorted_(first, leaf_entries_{}, n, target_fill, false);
+    }
+    free_nodes_(old_alloc, old_root);
+    compact_from.reset();
+  }
+
+  // the incremental form of `compact()`, repacks the leaves under up to `max_parents` index nodes
+  // to `target_fill`, in place. returns false once a pass over the whole tree is done, the next call starts over.
+  // this packs half-empty leaves, only `compact()` restores the order in memory.
+  bool compact_step(std::size_t max_parents = 1, double target_fill = 1.0) {
+    std::size_t target{static_cast<std::size_t>(target_fill * static_cast<double>(MAX_KEYS) + 0.5)};
+    target = std::clamp(target, MIN_KEYS + 1, MAX_KEYS);
+    for (std::size_t step = 0; step < max_parents; step++) {
+      if (root_underflow_()) {
+        fix_root_underflow_();
+      }
+      if (root->is_leaf) {
+        compact_from.reset();
+        return false;
+      }
+      descent path{};
+      node_type *parent{root};
+      while (!parent->idx.key_ptr[0]->is_leaf) {
+        std::size_t i{compact_from ? parent->find_idx_ptr_index_(*compact_from) : 0};
+        path.node[path.depth] = parent;
+        path.at[path.depth++] = i;
+        parent = parent->idx.key_ptr[i];
+      }
+      repack_leaves_(parent, target);
+      node_type *next{parent->idx.key_ptr[parent->key_cnt]->leaf.sib};
+      // a parent left with few leaves is merged with its siblings or takes some of theirs, and so on up the path.
+      // only index nodes move, the leaves stay where `compact_from` finds them.
+      for (node_type *cur{parent}; path.depth > 0 && is_underflow_(cur); cur = path.node[--path.depth]) {
+        fix_underflow_(cur, path.node[path.depth - 1], path.at[path.depth - 1]);
+      }
+      if (!next) {
+        compact_from.reset();
+        return false;
+      }
+      compact_from.emplace(next->key_at_(0));
+    }
+    return true;
+  }
+
+  // erases let a node fall to `keys` keys before fixing it, instead of `MIN_KEYS`: churn merges and splits
+  // the same nodes far less, at the price of emptier nodes until `rebalance()`. at least 2, `MIN_KEYS` is the default.
+  void set_low_water(std::size_t keys) noexcept {
+    low_water = std::clamp<std::size_t>(keys, 2, MIN_KEYS);
+  }
+
+  // brings every node back over `MIN_KEYS` keys where its siblings allow it, after erases under a lower `low_water`.
+  void rebalance() noexcept {
+    if (root_underflow_()) {
+      fix_root_underflow_();
+    }
+    if (!root->is_leaf) {
+      rebalance_(root);
+    }
+    if (root_underflow_()) {
+      fix_root_underflow_();
+    }
+  }
+
+  b_tree_stats stats() const {
+    b_tree_stats st{};
+    std::vector<const node_type *> level{root}, below{};
+    while (!level.empty()) {
+      st.height++;
+      below.clear();
+      for (const node_type *cur : level) {
+        st.nodes++;
+        if (cur->is_leaf) {
+          st.leaves++;
+          st.keys += cur->key_cnt;
+          st.fill[std::min<std::size_t>(cur->key_cnt * 10 / MAX_KEYS, 9)]++;
+          st.adjacent_leaves += cur->leaf.sib && cur->leaf.sib == cur + 1;
+        } else {
+          below.insert(below.end(), cur->idx.key_ptr, cur->idx.key_ptr + cur->key_cnt + 1);
+        }
+      }
+      level.swap(below);
+    }
+    st.bytes = st.leaves * b_leaf_bytes_<node_type>() + (st.nodes - st.leaves) * sizeof(node_type);
+    if constexpr (requires { alloc.reserved_bytes(); }) {
+      st.reserved_bytes = alloc.reserved_bytes();
+    } else {
+      st.reserved_bytes = st.bytes;
+    }
+    return st;
+  }
+
+  // `hi`, when given, receives the separator right after the leaf, `path` the way down.
+  node_type *insert_down_to_leaf(node_type *root, const key_type &k, bound *hi = nullptr,
+                                 descent *path = nullptr) noexcept {
     node_type *cur{root}, *next{};
     std::size_t next_from{};
+    if (hi) *hi = {};
+    count_(b_event::DESCENTS);
     while (!cur->is_leaf) {
+      count_(b_event::DESCENT_LEVELS);
       next_from = cur->find_idx_ptr_index_(k);
       next = cur->idx.key_ptr[next_from];
       if (is_overflow_(next)) {
-        fix_overflow_(next, cur, next_from);
+        if (next->is_leaf && !next->leaf.sib && next->key_at_(next->key_cnt - 1) < k) {
+          do_append_split_(next, cur, next_from);
+        } else {
+          fix_overflow_(next, cur, next_from);
+        }
         next_from = cur->find_idx_ptr_index_(k);
       }
+      if (hi && next_from < cur->key_cnt) *hi = {cur, next_from};
+      if (path) {
+        path->node[path->depth] = cur;
+        path->at[path->depth++] = next_from;
+      }
       cur = cur->idx.key_ptr[next_from];
     }
     return cur;
   }
 
-  bool insert_leaf(node_type *cur, const key_type &k, val_type *v) noexcept {
-    std::size_t check{cur->find_data_ptr_index_(k)};
-    std::size_t idx{cur->find_idx_ptr_index_(k)};
+  // the index of `k` in `cur`, put there with `v` if it was missing, and whether it was.
+  // keys are unique, the first key `>= k` is `k` itself or where it goes.
+  std::pair<std::size_t, bool> emplace_leaf_(node_type *cur, const key_type &k, slot_type v) noexcept {
+    std::size_t idx{cur->find_data_ptr_index_(k)};
     // NO DUPLICATED KEY SUPPORTED
-    if (check < cur->key_cnt && cur->key[check] == k) {
-      return false;
+    if (idx < cur->key_cnt && cur->key_at_(idx) == k) {
+      return {idx, false};
     }
     if (idx != cur->key_cnt) {
-      std::memmove(cur->leaf.data_ptr + idx + 1, cur->leaf.data_ptr + idx, (cur->key_cnt - idx) * sizeof(val_type *));
-      std::memmove(cur->key + idx + 1, cur->key + idx, (cur->key_cnt - idx) * sizeof(key_type));
+      count_(b_event::MOVED_BYTES, (cur->key_cnt - idx) * ENTRY_BYTES);
+      std::memmove(cur->leaf.data + idx + 1, cur->leaf.data + idx, (cur->key_cnt - idx) * sizeof(slot_type));
+      cur->move_keys_(idx + 1, idx, cur->key_cnt - idx);
     }
-    cur->leaf.data_ptr[idx] = v;
-    cur->key[idx] = k;
+    cur->leaf.data[idx] = v;
+    cur->set_key_(idx, k);
     cur->key_cnt++;
-    return true;
+    return {idx, true};
+  }
+
+  bool insert_leaf(node_type *cur, const key_type &k, slot_type v) noexcept {
+    return emplace_leaf_(cur, k, v).second;
   }
 
-  bool insert(const key_type &k, val_type *v) noexcept {
+  // keys landing in the last leaf, ascending ones above all, skip the descent.
+  bool insert(const key_type &k, slot_type v) noexcept {
+    if (!node_type::key_fits_(k)) return false;
+    if (track_tail && leaf_takes_(tail_(), k)) {
+      return insert_leaf(tail, k, v);
+    }
     if (root_overflow_(root)) {
       fix_root_overflow_();
     }
@@ -610,10 +1991,55 @@ public:
     return insert_leaf(cur, k, v);
   }
 
-  node_type *erase_down_to_leaf(node_type *root, const key_type &k) noexcept {
+  // the upserts below descend once, as `insert()`, and work on the leaf it ends in.
+  // a key the node cannot store is neither found nor inserted.
+
+  // inserts `v` unless `k` is there, returns the value of `k` and whether `v` was inserted.
+  std::pair<val_type *, bool> try_emplace(const key_type &k, slot_type v) noexcept {
+    if (!node_type::key_fits_(k)) return {nullptr, false};
+    if (root_overflow_(root)) {
+      fix_root_overflow_();
+    }
+    node_type *cur{insert_down_to_leaf(root, k)};
+    auto [idx, inserted]{emplace_leaf_(cur, k, v)};
+    return {cur->val_ptr_(idx), inserted};
+  }
+
+  // `k` maps to `v` afterwards, returns true if `k` was inserted, false if its slot was overwritten.
+  bool insert_or_assign(const key_type &k, slot_type v) noexcept {
+    if (!node_type::key_fits_(k)) return false;
+    if (root_overflow_(root)) {
+      fix_root_overflow_();
+    }
+    node_type *cur{insert_down_to_leaf(root, k)};
+    auto [idx, inserted]{emplace_leaf_(cur, k, v)};
+    if (!inserted) cur->leaf.data[idx] = v;
+    return inserted;
+  }
+
+  // calls `fn(val_type *)` on the value of `k`, inserted as `init` first if missing.
+  // returns whether `k` was there.
+  template<typename updater>
+  bool update(const key_type &k, slot_type init, updater &&fn) {
+    if (!node_type::key_fits_(k)) return false;
+    if (root_overflow_(root)) {
+      fix_root_overflow_();
+    }
+    node_type *cur{insert_down_to_leaf(root, k)};
+    auto [idx, inserted]{emplace_leaf_(cur, k, init)};
+    fn(cur->val_ptr_(idx));
+    return !inserted;
+  }
+
+  // `hi` and `path` work as in `insert_down_to_leaf()`.
+  node_type *erase_down_to_leaf(node_type *root, const key_type &k, bound *hi = nullptr,
+                                descent *path = nullptr) noexcept {
     node_type *cur{root}, *next{};
     std::size_t next_from{};
+    if (hi) *hi = {};
+    count_(b_event::DESCENTS);
     while (!cur->is_leaf) {
+      count_(b_event::DESCENT_LEVELS);
       next_from = cur->find_idx_ptr_index_(k);
       next = cur->idx.key_ptr[next_from];
       if (is_underflow_(next)) {
@@ -621,6 +2047,11 @@ public:
         if (cur->is_leaf) break;
         next_from = cur->find_idx_ptr_index_(k);
       }
+      if (hi && next_from < cur->key_cnt) *hi = {cur, next_from};
+      if (path) {
+        path->node[path->depth] = cur;
+        path->at[path->depth++] = next_from;
+      }
       cur = cur->idx.key_ptr[next_from];
     }
     return cur;
@@ -628,15 +2059,16 @@ public:
 
   bool erase_leaf(node_type *cur, const key_type &k) noexcept {
     std::size_t check{cur->find_data_ptr_index_(k)};
-    if (check == cur->key_cnt || cur->key[check] != k) {
+    if (check == cur->key_cnt || cur->key_at_(check) != k) {
       return false;
     }
     if (check != cur->key_cnt - 1) {
-      std::memmove(cur->leaf.data_ptr + check, cur->leaf.data_ptr + check + 1,
-                   (cur->key_cnt - (check + 1)) * sizeof(val_type *));
-      std::memmove(cur->key + check, cur->key + check + 1, (cur->key_cnt - (check + 1)) * sizeof(key_type));
+      count_(b_event::MOVED_BYTES, (cur->key_cnt - (check + 1)) * ENTRY_BYTES);
+      std::memmove(cur->leaf.data + check, cur->leaf.data + check + 1,
+                   (cur->key_cnt - (check + 1)) * sizeof(slot_type));
+      cur->move_keys_(check, check + 1, cur->key_cnt - (check + 1));
     }
-    cur->key_cnt--;
+    shrink_(cur, cur->key_cnt - 1);
     return true;
   }
 
@@ -649,33 +2081,168 @@ public:
     return erase_leaf(cur, k);
   }
 
+  // merges the front of a sorted batch into `cur` in one backward pass.
+  // stops at the leaf's upper separator `hi` or when the leaf is full, returns where it stopped.
+  template<typename iter>
+  iter insert_leaf_batch(node_type *cur, iter first, iter last, bound hi, std::size_t &inserted) noexcept {
+    // the batch outlives this call, keep pointers into it.
+    const key_type *add_key[MAX_KEYS];
+    slot_type add_val[MAX_KEYS];
+    std::size_t room{MAX_KEYS - cur->key_cnt}, add{0};
+    std::size_t li{cur->find_data_ptr_index_(std::get<0>(*first))};
+
+    for (; first != last && add < room; ++first) {
+      const key_type &k{std::get<0>(*first)};
+      if (!hi.above(k)) break;
+      if (!node_type::key_fits_(k)) continue;
+      while (li < cur->key_cnt && cur->key_at_(li) < k) {
+        li++;
+      }
+      // already in the leaf, or repeated in the batch, first one wins.
+      if (li < cur->key_cnt && !(k < cur->key_at_(li))) continue;
+      if (add > 0 && !(*add_key[add - 1] < k)) continue;
+      add_key[add] = &k;
+      add_val[add] = std::get<1>(*first);
+      add++;
+    }
+
+    std::size_t w{cur->key_cnt + add}, i{cur->key_cnt}, j{add};
+    while (j > 0) {
+      w--;
+      if (i > 0 && *add_key[j - 1] < cur->key_at_(i - 1)) {
+        i--;
+        cur->move_keys_(w, i, 1);
+        cur->leaf.data[w] = cur->leaf.data[i];
+      } else {
+        j--;
+        cur->set_key_(w, *add_key[j]);
+        cur->leaf.data[w] = add_val[j];
+      }
+    }
+    cur->key_cnt += add;
+    inserted += add;
+    return first;
+  }
+
+  // drops the front of a sorted batch from `cur` in one forward pass.
+  // stops at `hi` or once the leaf would fall under `low_water`, returns where it stopped.
+  template<typename iter>
+  iter erase_leaf_batch(node_type *cur, iter first, iter last, bound hi, std::size_t &erased) noexcept {
+    std::size_t budget{cur == root ? cur->key_cnt : std::max<std::size_t>(cur->key_cnt, low_water + 1) - low_water};
+    budget = std::max<std::size_t>(budget, 1);
+    std::size_t r{cur->find_data_ptr_index_(*first)};
+    std::size_t w{r}, drop{0};
+
+    for (; first != last && drop < budget; ++first) {
+      const key_type &k{*first};
+      if (!hi.above(k)) break;
+      while (r < cur->key_cnt && cur->key_at_(r) < k) {
+        if (w != r) cur->move_keys_(w, r, 1);
+        cur->leaf.data[w] = cur->leaf.data[r];
+        r++;
+        w++;
+      }
+      if (r < cur->key_cnt && !(k < cur->key_at_(r))) {
+        r++;
+        drop++;
+      }
+    }
+
+    if (drop > 0) {
+      cur->move_keys_(w, r, cur->key_cnt - r);
+      std::memmove(cur->leaf.data + w, cur->leaf.data + r, (cur->key_cnt - r) * sizeof(slot_type));
+      shrink_(cur, cur->key_cnt - drop);
+    }
+    erased += drop;
+    return first;
+  }
+
+  // (key, slot) pairs, one descent per leaf touched.
+  // an unsorted batch is stable-sorted in place first.
+  template<std::random_access_iterator iter>
+  std::size_t insert_batch(iter first, iter last, bool sorted = false) {
+    if (!sorted) {
+      std::stable_sort(first, last, [](const auto &a, const auto &b) { return std::get<0>(a) < std::get<0>(b); });
+    }
+    std::size_t inserted{0};
+    while (first != last) {
+      if (root_overflow_(root)) {
+        fix_root_overflow_();
+      }
+      bound hi{};
+      node_type *cur{insert_down_to_leaf(root, std::get<0>(*first), &hi)};
+      first = insert_leaf_batch(cur, first, last, hi, inserted);
+    }
+    return inserted;
+  }
+
+  // keys, one descent per leaf touched.
+  // an unsorted batch is sorted in place first.
+  template<std::random_access_iterator iter>
+  std::size_t erase_batch(iter first, iter last, bool sorted = false) {
+    if (!sorted) {
+      std::sort(first, last);
+    }
+    std::size_t erased{0};
+    while (first != last) {
+      if (root_underflow_()) {
+        fix_root_underflow_();
+      }
+      bound hi{};
+      node_type *cur{erase_down_to_leaf(root, *first, &hi)};
+      first = erase_leaf_batch(cur, first, last, hi, erased);
+    }
+    return erased;
+  }
+
+  // every key in [low, high): the subtrees in between are freed without looking at their keys, the two leaves
+  // holding the bounds are cut and linked, then only the paths down to them are rebalanced. returns how many keys went.
+  std::size_t erase_range(const key_type &low, const key_type &high) noexcept {
+    if (!(low < high)) return 0;
+    node_type *left{lower_down_to_leaf(root, low)}, *right{lower_down_to_leaf(root, high)};
+    std::size_t erased{cut_range_(root, &low, &high)};
+    if (left != right) left->leaf.sib = right;
+    repair_path_(low);
+    repair_path_(high);
+    return erased;
+  }
+
   node_type *find_down_to_leaf(node_type *root, const key_type &k) const {
     node_type *cur{root};
+    count_(b_event::DESCENTS);
     while (cur && !cur->is_leaf) {
+      count_(b_event::DESCENT_LEVELS);
       cur = cur->idx.key_ptr[cur->find_idx_ptr_index_(k)];
     }
     return cur;
   }
 
+  // the leftmost leaf that may hold `k`, keys equal to a separator can sit on both sides of it.
+  // the first key `>= k` is in that leaf or first in the next one.
+  node_type *lower_down_to_leaf(node_type *root, const key_type &k) const {
+    node_type *cur{root};
+    count_(b_event::DESCENTS);
+    while (!cur->is_leaf) {
+      count_(b_event::DESCENT_LEVELS);
+      cur = cur->idx.key_ptr[cur->find_data_ptr_index_(k)];
+    }
+    return cur;
+  }
+
   std::vector<val_type *> find_collect_range(node_type *cur, const key_type &low, const key_type &high) const {
     std::vector<val_type *> vals{};
-    while (cur) {
-      std::size_t beg{cur->find_data_ptr_index_(low)}, end{cur->find_idx_ptr_index_(high)};
-      if (end == 0) break;
-      for (std::size_t i = beg; i < end; i++) {
-        vals.emplace_back(cur->leaf.data_ptr[i]);
-      }
-      cur = cur->leaf.sib;
+    for (cursor it{cur, cur->find_data_ptr_index_(low)}; it != end() && it.key() < high; ++it) {
+      vals.emplace_back(it.value());
     }
     return vals;
   }
 
   val_type *find_collect_single(node_type *cur, const key_type &k) const {
     std::size_t beg{cur->find_data_ptr_index_(k)};
-    if (cur->key[beg] != k) {
+    if (beg == cur->key_cnt || cur->key_at_(beg) != k) {
       return nullptr;
     } else {
-      return cur->leaf.data_ptr[beg];
+      return cur->val_ptr_(beg);
     }
   }
 
@@ -684,9 +2251,633 @@ public:
     return find_collect_single(cur, k);
   }
 
+  // `out[i] = find_single(keys[i])` for `n` keys, returns how many were found.
+  // all leaves sit at the same depth, so a group of descents moves one level at a time:
+  // every key prefetches its next node before any of them searches it.
+  std::size_t find_many(const key_type *keys, std::size_t n, val_type **out) const {
+    constexpr std::size_t GROUP = 16;
+    std::size_t found{};
+    node_type *cur[GROUP];
+    for (std::size_t beg = 0; beg < n; beg += GROUP) {
+      std::size_t cnt{std::min(GROUP, n - beg)};
+      const key_type *k{keys + beg};
+      for (std::size_t j = 0; j < cnt; j++) {
+        cur[j] = root;
+      }
+      count_(b_event::DESCENTS, cnt);
+      while (!cur[0]->is_leaf) {
+        count_(b_event::DESCENT_LEVELS, cnt);
+        for (std::size_t j = 0; j < cnt; j++) {
+          cur[j] = cur[j]->idx.key_ptr[cur[j]->find_idx_ptr_index_(k[j])];
+          prefetch_node_(cur[j]);
+        }
+      }
+      for (std::size_t j = 0; j < cnt; j++) {
+        out[beg + j] = find_collect_single(cur[j], k[j]);
+        found += out[beg + j] != nullptr;
+      }
+    }
+    return found;
+  }
+
   // [low, high)
   std::vector<val_type *> find_range(const key_type &low, const key_type &high) const {
-    node_type *cur{find_down_to_leaf(root, low)};
-    return find_collect_range(cur, low, high);
+    std::vector<val_type *> vals{};
+    for (cursor it{lower_bound(low)}; it != end() && it.key() < high; ++it) {
+      vals.emplace_back(it.value());
+    }
+    return vals;
+  }
+
+  // walks the leaf chain lazily, yields (key, value pointer) pairs.
+  // any `insert` / `erase` may move keys between leaves, cursors do not survive them.
+  class cursor {
+    friend class b_star_tree;
+
+    node_type *cur{};
+    std::size_t pos{};
+
+    // leaves can be empty only as the root, but never stop on one.
+    void skip_empty_() noexcept {
+      while (cur && pos == cur->key_cnt) {
+        cur = cur->leaf.sib;
+        pos = 0;
+      }
+    }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::pair<key_ref, val_type *>;
+    using reference = value_type;
+
+    cursor() = default;
+    cursor(node_type *leaf, std::size_t pos) noexcept : cur{leaf}, pos{pos} {
+      skip_empty_();
+    }
+
+    key_ref key() const noexcept {
+      return cur->key_at_(pos);
+    }
+    val_type *value() const noexcept {
+      return cur->val_ptr_(pos);
+    }
+    reference operator*() const noexcept {
+      return {key(), value()};
+    }
+
+    cursor &operator++() noexcept {
+      pos++;
+      skip_empty_();
+      return *this;
+    }
+    cursor operator++(int) noexcept {
+      cursor old{*this};
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const cursor &obj) const noexcept {
+      return cur == obj.cur && pos == obj.pos;
+    }
+  };
+
+  cursor begin() const noexcept {
+    node_type *cur{root};
+    while (!cur->is_leaf) {
+      cur = cur->idx.key_ptr[0];
+    }
+    return cursor{cur, 0};
+  }
+
+  cursor end() const noexcept {
+    return cursor{};
+  }
+
+  // first key `>= k`.
+  cursor lower_bound(const key_type &k) const {
+    node_type *cur{lower_down_to_leaf(root, k)};
+    return cursor{cur, cur->find_data_ptr_index_(k)};
+  }
+
+  // first key `> k`.
+  cursor upper_bound(const key_type &k) const {
+    node_type *cur{find_down_to_leaf(root, k)};
+    return cursor{cur, cur->find_idx_ptr_index_(k)};
+  }
+
+  // `insert()` into the leaf of `hint` without a descent when `k` falls inside it, `end()` stands for the last leaf.
+  // returns a cursor at `k`, the hint for a next key nearby, or `end()` for a key the node cannot store.
+  cursor insert_hint(cursor hint, const key_type &k, slot_type v) noexcept {
+    if (!node_type::key_fits_(k)) return end();
+    node_type *cur{hint.cur ? hint.cur : track_tail ? tail_() : nullptr};
+    if (!cur || !leaf_takes_(cur, k)) {
+      if (root_overflow_(root)) {
+        fix_root_overflow_();
+      }
+      cur = insert_down_to_leaf(root, k);
+    }
+    return cursor{cur, emplace_leaf_(cur, k, v).first};
+  }
+
+  // writes the tree to `path` as an image for `b_star_mapped`, through a temporary file synced and renamed over `path`.
+  // a null `val_type *` slot is saved as `val_type{}`.
+  bool save(const char *path) const {
+    using page_type = b_image_page<key_type, val_type, M>;
+    constexpr std::size_t PAGE{b_image_page_bytes_<key_type, val_type, M>};
+    static constexpr char zero[PAGE]{};
+
+    // level order, the upper levels share the first pages and the leaves come last, left to right.
+    std::vector<const node_type *> order{root};
+    std::uint64_t size{0};
+    for (std::size_t i = 0; i < order.size(); i++) {
+      const node_type *cur{order[i]};
+      if (cur->is_leaf) {
+        size += cur->key_cnt;
+      } else {
+        order.insert(order.end(), cur->idx.key_ptr, cur->idx.key_ptr + cur->key_cnt + 1);
+      }
+    }
+
+    std::string tmp{std::string{path} + ".tmp"};
+    std::FILE *f{std::fopen(tmp.c_str(), "wb")};
+    if (!f) return false;
+
+    // counted in bytes, the padding may be empty.
+    auto put = [f](const void *p, std::size_t n) -> bool {
+      return std::fwrite(p, 1, n, f) == n;
+    };
+    b_image_header head{b_image_header::MAGIC, M, sizeof(key_type), sizeof(val_type), PAGE, 1, order.size() + 1, size};
+    bool ok{put(&head, sizeof(head)) && put(zero, PAGE - sizeof(head))};
+
+    // node `order[i]` goes to page `i + 1`, children are numbered in the order they were queued.
+    std::uint64_t child{2};
+    page_type pg;
+    for (std::size_t i = 0; ok && i < order.size(); i++) {
+      const node_type *cur{order[i]};
+      std::memset(&pg, 0, sizeof(pg));
+      pg.key_cnt = cur->key_cnt;
+      pg.is_leaf = cur->is_leaf;
+      for (std::size_t j = 0; j < cur->key_cnt; j++) {
+        pg.key[j] = cur->key_at_(j);
+      }
+      if (cur->is_leaf) {
+        for (std::size_t j = 0; j < cur->key_cnt; j++) {
+          const val_type *v{const_cast<node_type *>(cur)->val_ptr_(j)};
+          pg.leaf.data[j] = v ? *v : val_type{};
+        }
+        pg.leaf.sib = cur->leaf.sib ? i + 2 : 0;
+      } else {
+        for (std::size_t j = 0; j <= cur->key_cnt; j++) {
+          pg.idx.key_ptr[j] = child++;
+        }
+      }
+      ok = put(&pg, sizeof(pg)) && put(zero, PAGE - sizeof(pg));
+    }
+
+    ok = ok && std::fflush(f) == 0 && ::fsync(::fileno(f)) == 0;
+    ok = std::fclose(f) == 0 && ok;
+    if (ok) ok = std::rename(tmp.c_str(), path) == 0;
+    if (!ok) std::remove(tmp.c_str());
+    return ok;
+  }
+
+  // a read-only copy of every entry in `b_star_frozen`'s packed layout, the tree stays as it is.
+  // a null `val_type *` slot is copied as `val_type{}`.
+  template<std::size_t B = b_frozen_width_<key_type>>
+  b_star_frozen<key_type, val_type, B> freeze() const {
+    std::vector<std::pair<key_type, val_type>> rows{};
+    for (cursor it{begin()}; it != end(); ++it) {
+      const val_type *v{it.value()};
+      rows.emplace_back(it.key(), v ? *v : val_type{});
+    }
+    return b_star_frozen<key_type, val_type, B>{rows.begin(), rows.end()};
+  }
+
+  // calls `fn(key, value pointer)` for every key in [low, high) without allocating,
+  // a `fn` returning bool stops the scan on `false`. returns the number of calls.
+  template<typename visitor>
+  std::size_t for_each_in_range(const key_type &low, const key_type &high, visitor &&fn) const {
+    std::size_t visited{};
+    node_type *cur{lower_down_to_leaf(root, low)};
+    std::size_t i{cur->find_data_ptr_index_(low)};
+    while (cur) {
+      for (; i < cur->key_cnt; i++) {
+        if (!(cur->key_at_(i) < high)) return visited;
+        visited++;
+        if constexpr (std::is_same_v<std::invoke_result_t<visitor &, key_ref, val_type *>, bool>) {
+          if (!fn(cur->key_at_(i), cur->val_ptr_(i))) return visited;
+        } else {
+          fn(cur->key_at_(i), cur->val_ptr_(i));
+        }
+      }
+      cur = cur->leaf.sib;
+      i = 0;
+    }
+    return visited;
+  }
+
+  // folds [low, high) over `threads` threads, for aggregates that read a good part of the tree. the subtrees under
+  // the root holding the range, split further down until there are a few per thread, each start from `init` and
+  // go through `fn(acc, key, val_ptr)` in key order; `merge(acc, part)` then folds them left to right, so `init`
+  // should leave a part unchanged, 0 for a sum.
+  template<typename acc_type, typename folder, typename merger>
+  acc_type reduce_range(const key_type &low, const key_type &high, acc_type init, folder &&fn, merger &&merge,
+                        std::size_t threads) const {
+    if (!(low < high)) return init;
+    std::vector<node_type *> parts{root}, next{};
+    while (parts.size() < 4 * threads && !parts[0]->is_leaf) {
+      next.clear();
+      for (std::size_t p = 0; p < parts.size(); p++) {
+        node_type *cur{parts[p]};
+        std::size_t from{p == 0 ? cur->find_data_ptr_index_(low) : 0};
+        std::size_t to{p + 1 == parts.size() ? cur->find_data_ptr_index_(high) : cur->key_cnt};
+        next.insert(next.end(), cur->idx.key_ptr + from, cur->idx.key_ptr + to + 1);
+      }
+      parts.swap(next);
+    }
+
+    std::vector<acc_type> acc(parts.size(), init);
+    parallel_for_(threads, parts.size(), [&](std::size_t p) {
+      node_type *cur{p == 0 ? lower_down_to_leaf(parts[0], low) : leftmost_(parts[p])};
+      node_type *stop{p + 1 < parts.size() ? leftmost_(parts[p + 1]) : nullptr};
+      std::size_t i{p == 0 ? cur->find_data_ptr_index_(low) : 0};
+      // folded locally, neighbouring parts share cache lines in `acc`.
+      acc_type part{init};
+      for (bool more = true; more && cur != stop; cur = cur->leaf.sib, i = 0) {
+        for (; i < cur->key_cnt; i++) {
+          if (!(cur->key_at_(i) < high)) {
+            more = false;
+            break;
+          }
+          fn(part, cur->key_at_(i), cur->val_ptr_(i));
+        }
+      }
+      acc[p] = std::move(part);
+    });
+    for (std::size_t p = 1; p < parts.size(); p++) {
+      merge(acc[0], acc[p]);
+    }
+    return acc[0];
+  }
+};
+
+/*================================================*\
+
+  Read-only tree over a mapped image,
+  `b_star_mapped<key_type, val_type, M>` opens
+  what `b_star_tree<key_type, val_type, M>::save()`
+  wrote, with the same `M`.
+
+  Opening maps the file and checks the header,
+  pages are faulted in by the first lookups
+  touching them. Every page number is checked as
+  it is followed, a lookup never leaves the image.
+
+\*================================================*/
+
+template<typename key_type, typename val_type, std::size_t M>
+class b_star_mapped {
+protected:
+  using page_type = b_image_page<key_type, val_type, M>;
+  static constexpr std::size_t PAGE = b_image_page_bytes_<key_type, val_type, M>;
+
+  const char *base{};
+  std::size_t bytes{};
+
+  const b_image_header *head_() const noexcept {
+    return reinterpret_cast<const b_image_header *>(base);
+  }
+
+  const page_type *page_(std::uint64_t n) const noexcept {
+    return reinterpret_cast<const page_type *>(base + n * PAGE);
+  }
+
+  // page `n` linked from page `from`, or null when the image is corrupt. `save()` writes the nodes in level order,
+  // so a child or a sibling always comes after the page pointing to it, which also rules out cycles.
+  const page_type *link_(std::uint64_t from, std::uint64_t n) const noexcept {
+    if (n <= from || n >= head_()->page_cnt) return nullptr;
+    const page_type *p{page_(n)};
+    return p->key_cnt < M ? p : nullptr;
+  }
+
+  std::uint64_t page_no_(const page_type *p) const noexcept {
+    return static_cast<std::uint64_t>(reinterpret_cast<const char *>(p) - base) / PAGE;
+  }
+
+  template<bool INCLUSIVE>
+  static std::size_t search_(const page_type *p, const key_type &k) noexcept {
+    if constexpr (b_simd_key_v<key_type>) {
+      return b_branchless_search_<INCLUSIVE>(p->key, p->key_cnt, k);
+    } else {
+      return b_binary_search_<INCLUSIVE>(p->key, p->key_cnt, k);
+    }
+  }
+
+  // null when a page number on the way is out of place.
+  const page_type *find_down_to_leaf(const key_type &k) const noexcept {
+    const page_type *cur{link_(0, head_()->root)};
+    while (cur && !cur->is_leaf) {
+      cur = link_(page_no_(cur), cur->idx.key_ptr[search_<true>(cur, k)]);
+    }
+    return cur;
+  }
+
+public:
+  b_star_mapped() = default;
+  b_star_mapped(const b_star_mapped &) = delete;
+  b_star_mapped &operator=(const b_star_mapped &) = delete;
+  b_star_mapped(b_star_mapped &&obj) noexcept : base{std::exchange(obj.base, nullptr)}, bytes{obj.bytes} {}
+  b_star_mapped &operator=(b_star_mapped &&obj) noexcept {
+    if (this != &obj) {
+      unmap();
+      base = std::exchange(obj.base, nullptr);
+      bytes = obj.bytes;
+    }
+    return *this;
+  }
+  ~b_star_mapped() {
+    unmap();
+  }
+
+  // false, and nothing mapped, when the file is missing or was written for other types or another `M`.
+  bool open_mapped(const char *path) {
+    unmap();
+    int fd{::open(path, O_RDONLY)};
+    if (fd < 0) return false;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < PAGE) {
+      ::close(fd);
+      return false;
+    }
+    bytes = static_cast<std::size_t>(st.st_size);
+    void *p{::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0)};
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    base = static_cast<const char *>(p);
+    // lookups jump between pages, read-ahead would mostly fetch pages nobody asked for.
+    ::madvise(p, bytes, MADV_RANDOM);
+
+    const b_image_header *h{head_()};
+    if (h->magic != b_image_header::MAGIC || h->m != M || h->key_bytes != sizeof(key_type) ||
+        h->val_bytes != sizeof(val_type) || h->page_bytes != PAGE || h->page_cnt > bytes / PAGE || h->root == 0 ||
+        h->root >= h->page_cnt) {
+      unmap();
+      return false;
+    }
+    return true;
+  }
+
+  void unmap() noexcept {
+    if (base) ::munmap(const_cast<char *>(base), bytes);
+    base = nullptr;
+    bytes = 0;
+  }
+
+  bool is_open() const noexcept {
+    return base != nullptr;
+  }
+
+  // 0 when nothing is mapped.
+  std::size_t size() const noexcept {
+    return base ? head_()->size : 0;
+  }
+
+  // a corrupt image finds nothing past the bad page number.
+  const val_type *find_single(const key_type &k) const noexcept {
+    const page_type *cur{find_down_to_leaf(k)};
+    if (!cur) return nullptr;
+    std::size_t i{search_<false>(cur, k)};
+    if (i == cur->key_cnt || cur->key[i] != k) {
+      return nullptr;
+    } else {
+      return &cur->leaf.data[i];
+    }
+  }
+
+  // same contract as `b_star_tree::for_each_in_range()`.
+  template<typename visitor>
+  std::size_t for_each_in_range(const key_type &low, const key_type &high, visitor &&fn) const {
+    std::size_t visited{};
+    const page_type *cur{find_down_to_leaf(low)};
+    if (!cur) return visited;
+    std::size_t i{search_<false>(cur, low)};
+    while (true) {
+      for (; i < cur->key_cnt; i++) {
+        if (!(cur->key[i] < high)) return visited;
+        visited++;
+        if constexpr (std::is_same_v<std::invoke_result_t<visitor &, const key_type &, const val_type *>, bool>) {
+          if (!fn(cur->key[i], &cur->leaf.data[i])) return visited;
+        } else {
+          fn(cur->key[i], &cur->leaf.data[i]);
+        }
+      }
+      if (cur->leaf.sib == 0) return visited;
+      cur = link_(page_no_(cur), cur->leaf.sib);
+      if (!cur) return visited;
+      i = 0;
+    }
+  }
+
+  // every key in order, e.g. to load the image back into a `b_star_tree`.
+  // false when a page number is out of place, after the keys before it.
+  template<typename visitor>
+  bool for_each(visitor &&fn) const {
+    const page_type *cur{link_(0, head_()->root)};
+    while (cur && !cur->is_leaf) {
+      cur = link_(page_no_(cur), cur->idx.key_ptr[0]);
+    }
+    while (cur) {
+      for (std::size_t i = 0; i < cur->key_cnt; i++) {
+        fn(cur->key[i], &cur->leaf.data[i]);
+      }
+      if (cur->leaf.sib == 0) return true;
+      cur = link_(page_no_(cur), cur->leaf.sib);
+    }
+    return false;
+  }
+
+  std::vector<const val_type *> find_range(const key_type &low, const key_type &high) const {
+    std::vector<const val_type *> vals{};
+    for_each_in_range(low, high, [&](const key_type &, const val_type *v) { vals.emplace_back(v); });
+    return vals;
+  }
+};
+
+/*================================================*\
+
+  Read-only packed tree, an S+-tree,
+  `b_star_frozen<key_type, val_type, B>` built by
+  `b_star_tree::freeze()` or from sorted pairs.
+
+  Every node holds exactly `B` keys, the last ones
+  padded with the largest key, `+inf` for floating
+  point ones, NaN is no key. The levels lie
+  one after the other in a single array, leaves
+  first. Node `j` of a level has children
+  `j * (B + 1) + i` on the level below, so there
+  are no pointers to follow: a lookup counts the
+  keys `< k` of one node per level with the SIMD
+  compares of `b_count_below_`. Index keys are the
+  first key of the subtree on their right.
+
+  The leaves are the sorted keys themselves, with
+  the values alongside, a range scan walks them.
+
+\*================================================*/
+
+template<typename key_type, typename val_type, std::size_t B>
+class b_star_frozen {
+  static_assert(b_simd_key_v<key_type>, "keys are padded with their largest value, arithmetic keys only");
+  static_assert(B >= 2);
+
+protected:
+  static constexpr std::size_t MAX_HEIGHT = 64;
+  static constexpr std::align_val_t ALIGN{64};
+  // no probe compares above it, `+inf` included.
+  static constexpr key_type PAD = std::numeric_limits<key_type>::has_infinity ? std::numeric_limits<key_type>::infinity()
+                                                                               : std::numeric_limits<key_type>::max();
+
+  // all levels, leaves at 0, `B` keys per node.
+  key_type *keys{};
+  std::vector<val_type> vals{};
+  std::size_t n{}, height{}, key_cnt{};
+  std::size_t offset[MAX_HEIGHT]{};
+
+  static constexpr std::size_t blocks_(std::size_t cnt) noexcept {
+    return (cnt + B - 1) / B;
+  }
+
+  // keys on the level above one of `cnt` keys.
+  static constexpr std::size_t above_(std::size_t cnt) noexcept {
+    return (blocks_(cnt) + B) / (B + 1) * B;
+  }
+
+  void release_() noexcept {
+    if (keys) ::operator delete(keys, ALIGN);
+    keys = nullptr;
+  }
+
+  // `sorted` holds the leaf keys, `vals` already matches it.
+  void build_(const std::vector<key_type> &sorted) {
+    n = sorted.size();
+    height = 0;
+    key_cnt = 0;
+    if (n == 0) return;
+    for (std::size_t cnt = blocks_(n) * B; ; cnt = above_(cnt)) {
+      offset[height++] = key_cnt;
+      key_cnt += cnt;
+      if (cnt <= B) break;
+    }
+    keys = static_cast<key_type *>(::operator new(key_cnt * sizeof(key_type), ALIGN));
+    std::copy(sorted.begin(), sorted.end(), keys);
+    std::fill(keys + n, keys + (height > 1 ? offset[1] : key_cnt), PAD);
+    for (std::size_t h = 1; h < height; h++) {
+      std::size_t end{h + 1 < height ? offset[h + 1] : key_cnt};
+      for (std::size_t i = offset[h]; i < end; i++) {
+        // the leftmost leaf under the child right of this key.
+        std::size_t j{i - offset[h]}, child{j / B * (B + 1) + j % B + 1};
+        for (std::size_t l = 1; l < h; l++) {
+          child *= B + 1;
+        }
+        keys[i] = child * B < n ? sorted[child * B] : PAD;
+      }
+    }
+  }
+
+  // position of the first key `>= k` among the leaves, `n` past the last one.
+  std::size_t lower_pos_(const key_type &k) const noexcept {
+    if (n == 0) return 0;
+    std::size_t at{0};
+    for (std::size_t h = height - 1; h > 0; h--) {
+      at = at * (B + 1) + b_count_below_<false>(keys + offset[h] + at * B, B, k);
+    }
+    return std::min(at * B + b_count_below_<false>(keys + at * B, B, k), n);
+  }
+
+public:
+  b_star_frozen() = default;
+
+  // sorted (key, value) pairs, of equal keys the first one is kept like `b_star_tree::bulk_load()` does.
+  template<std::forward_iterator iter>
+  b_star_frozen(iter first, iter last) {
+    std::vector<key_type> sorted{};
+    for (iter it = first; it != last; ++it) {
+      if (!sorted.empty() && !(sorted.back() < std::get<0>(*it))) continue;
+      sorted.push_back(std::get<0>(*it));
+      vals.push_back(std::get<1>(*it));
+    }
+    build_(sorted);
+  }
+
+  b_star_frozen(const b_star_frozen &) = delete;
+  b_star_frozen &operator=(const b_star_frozen &) = delete;
+  b_star_frozen(b_star_frozen &&obj) noexcept
+      : keys{std::exchange(obj.keys, nullptr)}, vals{std::move(obj.vals)}, n{std::exchange(obj.n, 0)},
+        height{std::exchange(obj.height, 0)}, key_cnt{std::exchange(obj.key_cnt, 0)} {
+    std::copy(obj.offset, obj.offset + MAX_HEIGHT, offset);
+  }
+  b_star_frozen &operator=(b_star_frozen &&obj) noexcept {
+    if (this != &obj) {
+      release_();
+      keys = std::exchange(obj.keys, nullptr);
+      vals = std::move(obj.vals);
+      n = std::exchange(obj.n, 0);
+      height = std::exchange(obj.height, 0);
+      key_cnt = std::exchange(obj.key_cnt, 0);
+      std::copy(obj.offset, obj.offset + MAX_HEIGHT, offset);
+    }
+    return *this;
+  }
+  ~b_star_frozen() {
+    release_();
+  }
+
+  std::size_t size() const noexcept {
+    return n;
+  }
+
+  // levels, the leaves included.
+  std::size_t levels() const noexcept {
+    return height;
+  }
+
+  // keys of every level, padding included, and the values.
+  std::size_t bytes() const noexcept {
+    return key_cnt * sizeof(key_type) + n * sizeof(val_type);
+  }
+
+  const val_type *find_single(const key_type &k) const noexcept {
+    std::size_t i{lower_pos_(k)};
+    return i < n && keys[i] == k ? &vals[i] : nullptr;
+  }
+
+  // same contract as `b_star_tree::for_each_in_range()`.
+  template<typename visitor>
+  std::size_t for_each_in_range(const key_type &low, const key_type &high, visitor &&fn) const {
+    std::size_t i{lower_pos_(low)}, from{i};
+    for (; i < n && keys[i] < high; i++) {
+      if constexpr (std::is_same_v<std::invoke_result_t<visitor &, const key_type &, const val_type *>, bool>) {
+        if (!fn(keys[i], &vals[i])) return i - from + 1;
+      } else {
+        fn(keys[i], &vals[i]);
+      }
+    }
+    return i - from;
+  }
+
+  // [low, high)
+  std::vector<const val_type *> find_range(const key_type &low, const key_type &high) const {
+    std::vector<const val_type *> out{};
+    for_each_in_range(low, high, [&](const key_type &, const val_type *v) { out.emplace_back(v); });
+    return out;
+  }
+
+  // every key in order.
+  template<typename visitor>
+  void for_each(visitor &&fn) const {
+    for (std::size_t i = 0; i < n; i++) {
+      fn(keys[i], &vals[i]);
+    }
   }
 };
@@ -1,5 +1,13 @@
 #include <bits/stdc++.h>
+#include <malloc.h>
 
+#include "b_star_augmented.h"
+#include "b_star_buffered.h"
+#include "b_star_cow_tree.h"
+#include "b_star_durable.h"
+#include "b_star_multitree.h"
+#include "b_star_string_node.h"
+#include "b_star_tree_olc.h"
 #include "b_star_tree_refactored.h"
 
 using namespace std;
@@ -9,6 +17,28 @@ constexpr std::size_t SCALE{10000000};
 constexpr std::size_t FLOOR{145};
 
 using b_star = b_star_tree<ll, ll, FLOOR>;
+using b_star_inline = b_star_tree<ll, ll, FLOOR, b_star_inline_node<ll, ll, FLOOR>>;
+using b_star_heap = b_star_tree<ll, ll, FLOOR, b_star_node<ll, ll, FLOOR>, b_node_new_delete<b_star_node<ll, ll, FLOOR>>>;
+using b_star_olc = b_star_tree_olc<ll, ll, FLOOR>;
+using b_star_stats = b_star_tree<ll, ll, FLOOR, b_star_node<ll, ll, FLOOR>, b_node_arena<b_star_node<ll, ll, FLOOR>>,
+                                 b_thread_stats<>>;
+
+template<std::size_t M>
+using b_star_aligned = b_star_tree<ll, ll, M, b_star_aligned_node<ll, ll, M>>;
+constexpr std::size_t FANOUT_256{b_fanout_for_bytes<ll, ll *>(256)};
+constexpr std::size_t FANOUT_1K{b_fanout_for_bytes<ll, ll *>(1024)};
+constexpr std::size_t FANOUT_4K{b_fanout_for_bytes<ll, ll *>(4096)};
+static_assert(b_fanout_for_bytes<ll, ll *>(64) == 0, "a cache line holds no node of 7");
+
+using b_star_counted = b_star_augmented_tree<ll, ll, FLOOR>;
+using b_star_buffered = b_star_buffered_tree<ll, ll, FLOOR, b_buffered_node<ll, ll, FLOOR, ll>>;
+using b_star_cow = b_star_cow_tree<ll, ll, FLOOR, b_cow_node<ll, ll, FLOOR, ll>, b_cow_alloc<b_cow_node<ll, ll, FLOOR, ll>>,
+                                   b_thread_stats<>>;
+using b_star_multi = b_star_multitree<ll, ll, FLOOR, b_star_inline_node<ll, ll, FLOOR>>;
+using b_star_lists = b_star_tree<ll, std::vector<ll>, FLOOR>;
+
+using b_star_string = b_star_tree<std::string, ll, 64, b_star_node<std::string, ll, 64>>;
+using b_star_slotted = b_star_tree<std::string, ll, 64, b_star_string_node<ll, 64>>;
 
 double time_diff(const timespec &beg, const timespec &end) {
   return static_cast<double>(end.tv_sec - beg.tv_sec) +
@@ -52,21 +82,806 @@ void random_test() {
   puts("[RANDOM_TEST] PASSED !");
 }
 
-void bstar_benchmark() {
+// erases under `set_low_water(2)` and `erase_range()` leave index nodes with fewer than `MIN_KEYS` keys,
+// `compact_step()` passes over such a tree must keep every key and nothing else.
+void compact_test() {
+
+  puts("\n[COMPACT_TEST]");
+
+  using small = b_star_tree<ll, ll, 16, b_star_inline_node<ll, ll, 16>>;
+  std::mt19937_64 gen{29};
+  for (std::size_t round = 0; round < 20; round++) {
+    small t{};
+    t.set_low_water(2);
+    std::set<ll> ref{};
+    for (std::size_t i = 0; i < 200000; i++) {
+      ll k{static_cast<ll>(gen() % 1000000)};
+      t.insert(k, k);
+      ref.insert(k);
+    }
+    for (std::size_t i = 0; i < 150000; i++) {
+      ll k{static_cast<ll>(gen() % 1000000)};
+      t.erase(k);
+      ref.erase(k);
+    }
+    for (std::size_t i = 0; i < 50; i++) {
+      ll low{static_cast<ll>(gen() % 1000000)}, high{low + static_cast<ll>(gen() % 20000)};
+      t.erase_range(low, high);
+      ref.erase(ref.lower_bound(low), ref.lower_bound(high));
+    }
+    // moved away and back halfway, the passes go on where they stopped.
+    t.compact_step(1 + round % 4, round % 2 ? 1.0 : 0.8);
+    small moved{std::move(t)};
+    t = std::move(moved);
+    while (t.compact_step(1 + round % 4, round % 2 ? 1.0 : 0.8)) {
+    }
+    auto it{t.begin()};
+    for (ll k : ref) {
+      if (it == t.end() || it.key() != k || *it.value() != k || *t.find_single(k) != k) {
+        fprintf(stderr, "compact_step lost %lld\n", k);
+        _exit(-1);
+      }
+      ++it;
+    }
+    if (it != t.end()) {
+      fprintf(stderr, "compact_step kept an erased key\n");
+      _exit(-1);
+    }
+  }
+
+  puts("[COMPACT_TEST] PASSED !");
+}
+
+// `b_star_frozen` against a std::map, sizes around the level boundaries and the extreme keys of the type stored
+// and probed, `+inf` and `-inf` for floating point keys.
+template<typename key_type, std::size_t B>
+void frozen_check(std::size_t n, std::mt19937_64 &gen) {
+  using lim = std::numeric_limits<key_type>;
+  std::map<key_type, ll> ref{};
+  for (std::size_t i = 0; i < n; i++) {
+    ref.emplace(static_cast<key_type>(gen() % (4 * n + 1)), static_cast<ll>(i));
+  }
+  std::vector<key_type> edges{lim::lowest(), lim::max(), lim::min()};
+  if constexpr (lim::has_infinity) {
+    edges.insert(edges.end(), {lim::infinity(), -lim::infinity()});
+  }
+  if (n % 2) {
+    for (key_type k : edges) {
+      ref.emplace(k, -1);
+    }
+  }
+  b_star_frozen<key_type, ll, B> f{ref.begin(), ref.end()};
+  auto probe = [&](key_type k) {
+    auto it{ref.find(k)};
+    const ll *v{f.find_single(k)};
+    if ((it == ref.end()) != (v == nullptr) || (v && *v != it->second)) {
+      fprintf(stderr, "frozen find mismatch, %zu keys\n", n);
+      _exit(-1);
+    }
+  };
+  for (auto &[k, v] : ref) {
+    probe(k);
+  }
+  for (key_type k : edges) {
+    probe(k);
+  }
+  for (std::size_t i = 0; i < n; i++) {
+    probe(static_cast<key_type>(gen() % (4 * n + 2)));
+  }
+  edges.push_back(static_cast<key_type>(n));
+  for (key_type low : edges) {
+    for (key_type high : edges) {
+      std::vector<const ll *> got{f.find_range(low, high)};
+      std::size_t i{0};
+      for (auto it{ref.lower_bound(low)}; low < high && it != ref.end() && it->first < high; ++it, i++) {
+        if (i == got.size() || *got[i] != it->second) break;
+      }
+      if (i != got.size() || (low < high && i != static_cast<std::size_t>(std::distance(
+                                                     ref.lower_bound(low), ref.lower_bound(high))))) {
+        fprintf(stderr, "frozen range mismatch, %zu keys\n", n);
+        _exit(-1);
+      }
+    }
+  }
+}
+
+void frozen_test() {
+
+  puts("\n[FROZEN_TEST]");
+
+  std::mt19937_64 gen{31};
+  for (std::size_t n : {0, 1, 2, 3, 15, 16, 17, 271, 272, 273, 1000, 4624, 4625, 100003}) {
+    frozen_check<ll, 4>(n, gen);
+    frozen_check<ll, 16>(n, gen);
+    frozen_check<unsigned, 32>(n, gen);
+    frozen_check<double, 16>(n, gen);
+    frozen_check<float, 8>(n, gen);
+  }
+
+  puts("[FROZEN_TEST] PASSED !");
+}
+
+// `b_star_durable` reopened after a clean close, a torn tail, a corrupt record in the middle of the log and a
+// checkpoint with more records after it. `int` keys next to `double` values leave padding in every record.
+void wal_test() {
+
+  puts("\n[WAL_TEST]");
+
+  using durable = b_star_durable<int, double, 16>;
+  using record = b_wal_record<int, double>;
+  const char *path{"bstar_tester_test.wal"};
+  std::string ckpt{std::string{path} + ".ckpt"};
+  std::remove(path);
+  std::remove(ckpt.c_str());
+
+  std::mt19937 gen{41};
+  // every logged change in order, and the state after each prefix of them.
+  std::vector<std::pair<int, bool>> ops{};
+  std::map<int, double> ref{};
+  auto apply = [](std::map<int, double> &m, std::pair<int, bool> op) {
+    if (op.second) {
+      m.emplace(op.first, op.first * 0.5);
+    } else {
+      m.erase(op.first);
+    }
+  };
+  auto write = [&](durable &t, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+      int k{static_cast<int>(gen() % 2000)};
+      bool ins{gen() % 3 != 0};
+      if (ins ? t.insert(k, k * 0.5) : t.erase(k)) {
+        ops.emplace_back(k, ins);
+        apply(ref, ops.back());
+      }
+    }
+  };
+  auto check = [&](const char *what, const std::map<int, double> &m) {
+    durable t{};
+    if (!t.open(path)) {
+      fprintf(stderr, "wal %s: open failed\n", what);
+      _exit(-1);
+    }
+    for (int k = 0; k < 2000; k++) {
+      auto it{m.find(k)};
+      std::optional<double> v{t.find_single(k)};
+      if (v.has_value() != (it != m.end()) || (v && *v != it->second)) {
+        fprintf(stderr, "wal %s: key %d differs\n", what, k);
+        _exit(-1);
+      }
+    }
+  };
+  auto log_bytes = [&]() { return static_cast<std::size_t>(std::filesystem::file_size(path)); };
+
+  {
+    durable t{};
+    t.open(path);
+    write(t, 3000);
+  }
+  check("clean close", ref);
+
+  // half a record at the end, as a crash in the middle of a write leaves it.
+  std::size_t whole{log_bytes()};
+  {
+    std::ofstream f{path, std::ios::binary | std::ios::app};
+    f.write("\x01\x00\x00\x00garbage", sizeof(record) / 2);
+  }
+  check("torn tail", ref);
+  if (log_bytes() != whole) {
+    fprintf(stderr, "wal torn tail: not truncated\n");
+    _exit(-1);
+  }
+
+  // one flipped bit in the key of record `bad`, only the records before it count.
+  std::size_t bad{ops.size() / 2};
+  {
+    std::fstream f{path, std::ios::binary | std::ios::in | std::ios::out};
+    f.seekg(static_cast<std::streamoff>(bad * sizeof(record) + offsetof(record, key)));
+    char c{};
+    f.get(c);
+    f.seekp(static_cast<std::streamoff>(bad * sizeof(record) + offsetof(record, key)));
+    f.put(static_cast<char>(c ^ 4));
+  }
+  ops.resize(bad);
+  ref.clear();
+  for (auto op : ops) {
+    apply(ref, op);
+  }
+  check("corrupt record", ref);
+  if (log_bytes() != bad * sizeof(record)) {
+    fprintf(stderr, "wal corrupt record: not truncated\n");
+    _exit(-1);
+  }
+
+  // a checkpoint, then inserts and erases of keys it holds.
+  {
+    durable t{};
+    t.open(path);
+    write(t, 1000);
+    if (!t.checkpoint()) {
+      fprintf(stderr, "wal checkpoint failed\n");
+      _exit(-1);
+    }
+    write(t, 1000);
+  }
+  check("checkpoint and log", ref);
+
+  std::remove(path);
+  std::remove(ckpt.c_str());
+  puts("[WAL_TEST] PASSED !");
+}
+
+// an image `save()` wrote read back through `b_star_mapped`, then with a child and a sibling page number out of range
+// or pointing backwards, where lookups must stop instead of leaving the mapping or looping.
+void mapped_test() {
+
+  puts("\n[MAPPED_TEST]");
+
+  using page_type = b_image_page<ll, ll, 16>;
+  constexpr std::size_t PAGE{b_image_page_bytes_<ll, ll, 16>};
+  const char *path{"bstar_tester_test.img"};
+
+  std::mt19937_64 gen{43};
+  std::map<ll, ll> ref{};
+  while (ref.size() < 5000) {
+    ll k{static_cast<ll>(gen() % 20000)};
+    ref.emplace(k, k * 3);
+  }
+  std::vector<ll> vals{};
+  vals.reserve(ref.size());
+  b_star_tree<ll, ll, 16> t{};
+  for (auto [k, v] : ref) {
+    vals.emplace_back(v);
+    t.insert(k, &vals.back());
+  }
+  if (!t.save(path)) {
+    fprintf(stderr, "mapped save failed\n");
+    _exit(-1);
+  }
+
+  b_star_mapped<ll, ll, 16> m{};
+  if (m.size() != 0) {
+    fprintf(stderr, "mapped size before open\n");
+    _exit(-1);
+  }
+  if (!m.open_mapped(path) || m.size() != ref.size()) {
+    fprintf(stderr, "mapped open failed\n");
+    _exit(-1);
+  }
+  for (ll k = -1; k <= 20000; k++) {
+    auto it{ref.find(k)};
+    const ll *v{m.find_single(k)};
+    if ((v != nullptr) != (it != ref.end()) || (v && *v != it->second)) {
+      fprintf(stderr, "mapped key %lld differs\n", k);
+      _exit(-1);
+    }
+  }
+  std::size_t seen{};
+  if (!m.for_each([&](const ll &, const ll *) { seen++; }) || seen != ref.size() ||
+      m.for_each_in_range(5000, 15000, [](const ll &, const ll *) {}) !=
+          static_cast<std::size_t>(std::distance(ref.lower_bound(5000), ref.lower_bound(15000)))) {
+    fprintf(stderr, "mapped walk mismatch\n");
+    _exit(-1);
+  }
+  m.unmap();
+  if (m.size() != 0) {
+    fprintf(stderr, "mapped size after unmap\n");
+    _exit(-1);
+  }
+
+  // the root is page 1, its first child comes right after it, the leaves fill the last pages.
+  std::uint64_t pages{static_cast<std::uint64_t>(std::filesystem::file_size(path)) / PAGE};
+  std::string image{};
+  {
+    std::ifstream f{path, std::ios::binary};
+    image.assign(std::istreambuf_iterator<char>{f}, {});
+  }
+  auto corrupt = [&](const char *what, std::uint64_t page, std::size_t at, std::uint64_t to) {
+    std::string bad{image};
+    std::memcpy(bad.data() + page * PAGE + at, &to, sizeof(to));
+    std::ofstream{path, std::ios::binary | std::ios::trunc}.write(bad.data(), static_cast<std::streamsize>(bad.size()));
+    b_star_mapped<ll, ll, 16> c{};
+    if (!c.open_mapped(path)) {
+      fprintf(stderr, "mapped %s: open failed\n", what);
+      _exit(-1);
+    }
+    for (auto [k, v] : ref) {
+      c.find_single(k);
+    }
+    c.for_each_in_range(LLONG_MIN, LLONG_MAX, [](const ll &, const ll *) {});
+    if (c.for_each([](const ll &, const ll *) {})) {
+      fprintf(stderr, "mapped %s: not noticed\n", what);
+      _exit(-1);
+    }
+  };
+  std::size_t child{offsetof(page_type, idx.key_ptr)}, sib{offsetof(page_type, leaf.sib)};
+  corrupt("child past the end", 1, child, pages + 7);
+  corrupt("child pointing back", 1, child, 1);
+  corrupt("sibling past the end", pages - 2, sib, ~std::uint64_t{0});
+  corrupt("sibling pointing back", pages - 2, sib, pages - 3);
+
+  std::remove(path);
+  puts("[MAPPED_TEST] PASSED !");
+}
+
+// `b_star_cow_tree` with inline values under every writer, with a few snapshots open at any time. each snapshot
+// must read what a std::map copy taken when it was opened holds, the live tree its leaf chain in order, and nothing
+// may stay retired once every view is closed.
+void cow_test() {
+
+  puts("\n[COW_TEST]");
+
+  using node = b_cow_node<ll, ll, 8, ll>;
+  using cow = b_star_cow_tree<ll, ll, 8, node, b_cow_alloc<node>>;
+  static_assert(std::is_same_v<decltype(std::declval<cow &>().find_single(0)), const ll *> &&
+                std::is_same_v<decltype(std::declval<cow &>().begin().value()), const ll *>);
+  constexpr ll KEYS{3000};
+
+  auto same = [](const char *what, const auto &t, const std::map<ll, ll> &ref) {
+    auto it{ref.begin()};
+    std::size_t n{t.for_each([&](ll k, const ll *v) {
+      if (it == ref.end() || it->first != k || it->second != *v) {
+        fprintf(stderr, "cow %s: key %lld differs\n", what, k);
+        _exit(-1);
+      }
+      ++it;
+    })};
+    for (ll k = -1; k <= KEYS; k += 7) {
+      auto r{ref.find(k)};
+      const ll *v{t.find_single(k)};
+      if ((v != nullptr) != (r != ref.end()) || (v && *v != r->second) || n != ref.size()) {
+        fprintf(stderr, "cow %s: find of %lld differs\n", what, k);
+        _exit(-1);
+      }
+    }
+  };
+
+  for (std::size_t low : {0, 2}) {
+    cow t{};
+    if (low) t.set_low_water(low);
+    std::map<ll, ll> ref{};
+    std::vector<std::pair<cow::view, std::map<ll, ll>>> snaps{};
+    std::mt19937_64 gen{47 + low};
+    for (std::size_t i = 0; i < 40000; i++) {
+      ll k{static_cast<ll>(gen() % KEYS)}, v{static_cast<ll>(gen() % 1000)};
+      switch (gen() % 6) {
+      case 0:
+        if (t.insert(k, v) != ref.emplace(k, v).second) {
+          fprintf(stderr, "cow insert of %lld disagrees\n", k);
+          _exit(-1);
+        }
+        break;
+      case 1:
+      case 2:
+        if (t.erase(k) != (ref.erase(k) == 1)) {
+          fprintf(stderr, "cow erase of %lld disagrees\n", k);
+          _exit(-1);
+        }
+        break;
+      case 3: {
+        auto [p, inserted]{t.try_emplace(k, v)};
+        if (inserted != ref.emplace(k, v).second || *p != ref[k]) {
+          fprintf(stderr, "cow try_emplace of %lld disagrees\n", k);
+          _exit(-1);
+        }
+        break;
+      }
+      case 4:
+        if (t.insert_or_assign(k, v) != !ref.contains(k)) {
+          fprintf(stderr, "cow insert_or_assign of %lld disagrees\n", k);
+          _exit(-1);
+        }
+        ref[k] = v;
+        break;
+      default:
+        if (t.update(k, v, [](ll *x) { *x += 1; }) != ref.contains(k)) {
+          fprintf(stderr, "cow update of %lld disagrees\n", k);
+          _exit(-1);
+        }
+        ref.emplace(k, v).first->second += 1;
+        break;
+      }
+      // a snapshot now and then, up to four open, the oldest closed first.
+      if (i % 997 == 0) {
+        if (snaps.size() == 4) {
+          same("snapshot", snaps.front().first, snaps.front().second);
+          snaps.erase(snaps.begin());
+        }
+        snaps.emplace_back(t.snapshot(), ref);
+      }
+      // everything replaced at once while the snapshots hold on to the old nodes.
+      if (i == 20000) {
+        std::vector<std::pair<ll, ll>> rows{};
+        for (ll j = 0; j < KEYS; j += 2) {
+          rows.emplace_back(j, -j);
+        }
+        t.bulk_load(rows.begin(), rows.end(), 0.7);
+        ref = {rows.begin(), rows.end()};
+      }
+    }
+    for (auto &[snap, at] : snaps) {
+      same("snapshot", snap, at);
+    }
+    same("live tree", t.snapshot(), ref);
+    auto it{ref.begin()};
+    for (cow::cursor c{t.begin()}; c != t.end(); ++c, ++it) {
+      if (it == ref.end() || c.key() != it->first || *c.value() != it->second) {
+        fprintf(stderr, "cow leaf chain differs at %lld\n", c.key());
+        _exit(-1);
+      }
+    }
+    if (it != ref.end()) {
+      fprintf(stderr, "cow leaf chain ends early\n");
+      _exit(-1);
+    }
+    snaps.clear();
+    if (t.retired_nodes() != 0) {
+      fprintf(stderr, "cow %zu nodes retired with every view closed\n", t.retired_nodes());
+      _exit(-1);
+    }
+  }
+
+  puts("[COW_TEST] PASSED !");
+}
+
+// the slotted string node against a std::map, keys from a few bytes to several heaps long, so nodes spill.
+void string_test() {
+
+  puts("\n[STRING_TEST]");
+
+  using small = b_star_tree<std::string, ll, 16, b_star_string_node<ll, 16, 256, ll>>;
+  static const char *hosts[]{"", "https://example.com/", "https://example.com/static/"};
+  std::mt19937_64 gen{31};
+  auto key = [&]() -> std::string {
+    std::uint64_t v{gen() % 20000};
+    // one key in 64 is longer than the whole heap.
+    std::size_t pad{v % 64 == 0 ? 300 + v % 700 : v % 40};
+    return hosts[v % 3] + std::string(pad, static_cast<char>('a' + v % 7)) + std::to_string(v);
+  };
+  for (std::size_t round = 0; round < 8; round++) {
+    small t{};
+    std::map<std::string, ll> ref{};
+    for (std::size_t i = 0; i < 60000; i++) {
+      std::string k{key()};
+      if (gen() % 3) {
+        bool fresh{ref.try_emplace(k, static_cast<ll>(i)).second};
+        if (t.insert(k, static_cast<ll>(i)) != fresh) {
+          fprintf(stderr, "string insert of %s disagrees\n", k.c_str());
+          _exit(-1);
+        }
+      } else if (t.erase(k) != (ref.erase(k) == 1)) {
+        fprintf(stderr, "string erase of %s disagrees\n", k.c_str());
+        _exit(-1);
+      }
+    }
+    if (round % 2) {
+      std::string low{key()}, high{key()};
+      if (high < low) std::swap(low, high);
+      t.erase_range(low, high);
+      ref.erase(ref.lower_bound(low), ref.lower_bound(high));
+    }
+    auto it{t.begin()};
+    for (const auto &[k, v] : ref) {
+      if (it == t.end() || it.key() != k || *it.value() != v || !t.find_single(k) || *t.find_single(k) != v) {
+        fprintf(stderr, "string tree lost %s\n", k.c_str());
+        _exit(-1);
+      }
+      ++it;
+    }
+    if (it != t.end()) {
+      fprintf(stderr, "string tree kept an erased key\n");
+      _exit(-1);
+    }
+  }
+
+  puts("[STRING_TEST] PASSED !");
+}
+
+// threads insert, erase and find their own keys, `k % THREADS == t`, against a std::set each, and scan the shared
+// range. a small fanout splits and merges all the time. worth running under -fsanitize=thread as well.
+void olc_test() {
+
+  puts("\n[OLC_TEST]");
+
+  using small = b_star_tree_olc<ll, ll, 16>;
+  constexpr std::size_t THREADS{4}, OPS{200000};
+  constexpr ll KEYS{40000};
+  for (std::size_t round = 0; round < 4; round++) {
+    small t{};
+    std::set<ll> own[THREADS]{};
+    for (ll k = 0; k < KEYS; k += 3) {
+      t.insert(k, reinterpret_cast<ll *>(k));
+      own[k % THREADS].insert(k);
+    }
+    std::vector<std::thread> pool{};
+    for (std::size_t id = 0; id < THREADS; id++) {
+      pool.emplace_back([&, id]() {
+        std::mt19937_64 gen{round * THREADS + id};
+        std::set<ll> &ref{own[id]};
+        for (std::size_t i = 0; i < OPS; i++) {
+          std::uint64_t r{gen()};
+          ll k{static_cast<ll>((r >> 8) % (KEYS / THREADS)) * static_cast<ll>(THREADS) + static_cast<ll>(id)};
+          std::size_t kind{r % 10};
+          if (kind < 4) {
+            if (t.insert(k, reinterpret_cast<ll *>(k)) != ref.insert(k).second) {
+              fprintf(stderr, "olc insert of %lld disagrees\n", k);
+              _exit(-1);
+            }
+          } else if (kind < 7) {
+            if (t.erase(k) != (ref.erase(k) == 1)) {
+              fprintf(stderr, "olc erase of %lld disagrees\n", k);
+              _exit(-1);
+            }
+          } else if (kind < 8) {
+            std::optional<ll *> v{t.find_single(k)};
+            if (v.has_value() != ref.contains(k) || (v && *v != reinterpret_cast<ll *>(k))) {
+              fprintf(stderr, "olc find of %lld disagrees\n", k);
+              _exit(-1);
+            }
+          } else if (kind < 9) {
+            // our keys from `k` on, more than a group, every one of them next to the others' keys.
+            ll many[20];
+            std::optional<ll *> got[20];
+            std::size_t want{};
+            for (std::size_t j = 0; j < 20; j++) {
+              many[j] = k + static_cast<ll>(j * THREADS);
+              want += ref.contains(many[j]);
+            }
+            if (t.find_many(many, 20, got) != want) {
+              fprintf(stderr, "olc find_many from %lld counted wrong\n", k);
+              _exit(-1);
+            }
+            for (std::size_t j = 0; j < 20; j++) {
+              bool hit{ref.contains(many[j])};
+              if (got[j].has_value() != hit || (got[j] && *got[j] != reinterpret_cast<ll *>(many[j]))) {
+                fprintf(stderr, "olc find_many of %lld disagrees\n", many[j]);
+                _exit(-1);
+              }
+            }
+          } else {
+            // the other threads' keys come and go, ours must all be there, in order.
+            ll prev{-1};
+            std::size_t mine{};
+            t.for_each_in_range(k, k + 400, [&](ll key, ll *v) {
+              if (key <= prev || v != reinterpret_cast<ll *>(key)) {
+                fprintf(stderr, "olc scan out of order at %lld\n", key);
+                _exit(-1);
+              }
+              prev = key;
+              mine += key % static_cast<ll>(THREADS) == static_cast<ll>(id);
+            });
+            if (mine != static_cast<std::size_t>(std::distance(ref.lower_bound(k), ref.lower_bound(k + 400)))) {
+              fprintf(stderr, "olc scan from %lld missed keys\n", k);
+              _exit(-1);
+            }
+          }
+        }
+      });
+    }
+    for (std::thread &th : pool) {
+      th.join();
+    }
+    std::set<ll> all{};
+    for (const std::set<ll> &ref : own) {
+      all.insert(ref.begin(), ref.end());
+    }
+    auto it{t.begin()};
+    for (ll k : all) {
+      if (it == t.end() || it.key() != k) {
+        fprintf(stderr, "olc tree lost %lld\n", k);
+        _exit(-1);
+      }
+      ++it;
+    }
+    if (it != t.end()) {
+      fprintf(stderr, "olc tree kept an erased key\n");
+      _exit(-1);
+    }
+  }
+
+  // one thread going back and forth between two trees, and on to a third after the first is gone,
+  // must not take more slabs than filling each tree on its own.
+  {
+    constexpr ll N{200000};
+    small alone{};
+    for (ll k = 0; k < N; k++) {
+      alone.insert(k, reinterpret_cast<ll *>(k));
+    }
+    std::optional<small> a{std::in_place};
+    small b{};
+    for (ll k = 0; k < N; k++) {
+      a->insert(k, reinterpret_cast<ll *>(k));
+      b.insert(k, reinterpret_cast<ll *>(k));
+    }
+    std::size_t most{alone.stats().reserved_bytes + (std::size_t{1} << 20)};
+    if (a->stats().reserved_bytes > most || b.stats().reserved_bytes > most) {
+      fprintf(stderr, "olc alternating trees reserved %zu and %zu bytes, %zu alone\n", a->stats().reserved_bytes,
+              b.stats().reserved_bytes, alone.stats().reserved_bytes);
+      _exit(-1);
+    }
+    a->insert(N, nullptr);
+    a.reset();
+    small c{};
+    for (ll k = 0; k < 1000; k++) {
+      c.insert(k, reinterpret_cast<ll *>(k));
+      b.erase(k);
+    }
+    if (c.find_single(999) != reinterpret_cast<ll *>(999) || b.find_single(999)) {
+      fprintf(stderr, "olc trees after one was destroyed disagree\n");
+      _exit(-1);
+    }
+  }
+
+  puts("[OLC_TEST] PASSED !");
+}
+
+// every write of `b_star_augmented_tree` against a std::map, then the summaries: sizes, ranks, range counts and
+// aggregates under the sum and the min monoid.
+void augmented_test() {
+
+  puts("\n[AUGMENTED_TEST]");
+
+  using summed = b_star_augmented_tree<ll, ll, 16>;
+  using least = b_star_augmented_tree<ll, ll, 16, b_star_augmented_node<ll, ll, 16, b_min_monoid<ll>>>;
+  std::mt19937_64 gen{37};
+  for (std::size_t round = 0; round < 10; round++) {
+    summed t{};
+    least m{};
+    std::map<ll, ll> ref{};
+    // the same write on both trees.
+    auto both = [&](auto &&op) {
+      op(t);
+      op(m);
+    };
+    for (std::size_t i = 0; i < 100000; i++) {
+      ll k{static_cast<ll>(gen() % 20000)}, v{static_cast<ll>(gen() % 1000)};
+      switch (gen() % 6) {
+      case 0:
+        both([&](auto &x) { x.insert(k, v); });
+        ref.try_emplace(k, v);
+        break;
+      case 1:
+        both([&](auto &x) { x.try_emplace(k, v); });
+        ref.try_emplace(k, v);
+        break;
+      case 2:
+        both([&](auto &x) { x.insert_or_assign(k, v); });
+        ref.insert_or_assign(k, v);
+        break;
+      case 3:
+        both([&](auto &x) { x.update(k, 0, [&](ll *p) { *p += v; }); });
+        ref[k] += v;
+        break;
+      case 4:
+        both([&](auto &x) { x.insert_hint(x.end(), k, v); });
+        ref.try_emplace(k, v);
+        break;
+      default:
+        both([&](auto &x) { x.erase(k); });
+        ref.erase(k);
+      }
+    }
+    if (round % 2) {
+      ll low{static_cast<ll>(gen() % 20000)}, high{low + static_cast<ll>(gen() % 2000)};
+      both([&](auto &x) { x.erase_range(low, high); });
+      ref.erase(ref.lower_bound(low), ref.lower_bound(high));
+      both([&](auto &x) {
+        while (x.compact_step(2)) {
+        }
+      });
+    } else {
+      // rebuilt from its own rows, the bulk load sums every index node.
+      std::vector<std::pair<ll, ll>> rows(ref.begin(), ref.end());
+      t = summed{rows.begin(), rows.end(), 0.7};
+    }
+    if (t.size() != ref.size() || m.size() != ref.size()) {
+      fprintf(stderr, "augmented size %zu, %zu keys\n", t.size(), ref.size());
+      _exit(-1);
+    }
+    for (std::size_t q = 0; q < 200; q++) {
+      ll low{static_cast<ll>(gen() % 20000)}, high{low + static_cast<ll>(gen() % 5000)};
+      ll sum{0}, least_v{std::numeric_limits<ll>::max()};
+      std::size_t cnt{0};
+      for (auto it{ref.lower_bound(low)}; it != ref.end() && it->first < high; ++it) {
+        sum += it->second;
+        least_v = std::min(least_v, it->second);
+        cnt++;
+      }
+      if (t.count_range(low, high) != cnt || t.aggregate_range(low, high) != sum ||
+          m.aggregate_range(low, high) != least_v ||
+          t.rank(low) != static_cast<std::size_t>(std::distance(ref.begin(), ref.lower_bound(low)))) {
+        fprintf(stderr, "augmented summaries of [%lld, %lld) are off\n", low, high);
+        _exit(-1);
+      }
+    }
+  }
+
+  puts("[AUGMENTED_TEST] PASSED !");
+}
+
+// writes into a buffered tree of fanout `M` next to `std::map`: finds with the messages still pending, then a range
+// read, a cursor walk and a frozen copy, each of which must see every write without a `flush()` first.
+template<std::size_t M>
+void buffered_check(std::size_t limit, std::mt19937_64 &gen) {
+  b_star_buffered_tree<ll, ll, M, b_buffered_node<ll, ll, M, ll>> t{};
+  t.set_buffer_limit(limit);
+  std::map<ll, ll> ref{};
+  auto fail = [&](const char *what) {
+    fprintf(stderr, "buffered M %zu limit %zu: %s, %zu keys, %zu pending\n", M, limit, what, ref.size(), t.pending());
+    _exit(-1);
+  };
+  for (std::size_t round = 0; round < 8; round++) {
+    // growing rounds, then shrinking ones.
+    std::size_t erase_odds{round < 4 ? 4u : 2u};
+    for (std::size_t i = 0; i < 20000; i++) {
+      ll k{static_cast<ll>(gen() % 5000)}, v{static_cast<ll>(gen() % 1000)};
+      std::size_t op{gen() % erase_odds};
+      if (op == 0) {
+        t.erase(k);
+        ref.erase(k);
+      } else if (op == 1) {
+        t.insert_or_assign(k, v);
+        ref.insert_or_assign(k, v);
+      } else {
+        t.insert(k, v);
+        ref.try_emplace(k, v);
+      }
+      ll q{static_cast<ll>(gen() % 5000)};
+      ll *found{t.find_single(q)};
+      auto it{ref.find(q)};
+      if ((found == nullptr) != (it == ref.end()) || (found && *found != it->second)) fail("find_single");
+    }
+
+    ll low{static_cast<ll>(gen() % 5000)}, high{low + static_cast<ll>(gen() % 2000)};
+    std::vector<std::pair<ll, ll>> seen{};
+    t.for_each_in_range(low, high, [&](ll k, ll *v) { seen.emplace_back(k, *v); });
+    if (t.pending() != 0) fail("pending after a range read");
+    if (seen != std::vector<std::pair<ll, ll>>(ref.lower_bound(low), ref.lower_bound(high))) fail("for_each_in_range");
+
+    t.insert_or_assign(low, -1);
+    ref.insert_or_assign(low, -1);
+    auto it{ref.lower_bound(low)};
+    for (auto c{t.lower_bound(low)}; c != t.end(); ++c, ++it) {
+      if (it == ref.end() || c.key() != it->first || *c.value() != it->second) fail("cursor");
+    }
+    if (it != ref.end()) fail("cursor ends early");
+
+    t.erase(low);
+    ref.erase(low);
+    auto frozen{t.freeze()};
+    if (frozen.size() != ref.size() || t.stats().keys != ref.size()) fail("freeze");
+  }
+}
+
+void buffered_test() {
+
+  puts("\n[BUFFERED_TEST]");
+
+  std::mt19937_64 gen{41};
+  for (std::size_t limit : {1, 3, 8, 40, 200}) {
+    buffered_check<8>(limit, gen);
+    buffered_check<16>(limit, gen);
+    buffered_check<64>(limit, gen);
+  }
+
+  puts("[BUFFERED_TEST] PASSED !");
+}
+
+template<typename tree_type>
+void bstar_benchmark(const char *name) {
 
   ll *keys{gen_data()};
 
-  b_star_tree<ll, ll, FLOOR> t{};
+  tree_type t{};
   timespec beg1{}, end1{}, beg2{}, end2{}, beg3{}, end3{};
 
-  std::cout << "B-star insert" << std::endl;
+  std::cout << name << " insert" << std::endl;
   clock_gettime(CLOCK_MONOTONIC, &beg1);
   for (std::size_t i = 0; i < SCALE; i++) {
     t.insert(keys[i], (ll *)i);
   }
   clock_gettime(CLOCK_MONOTONIC, &end1);
 
-  std::cout << "B-star find" << std::endl;
+  std::cout << name << " find" << std::endl;
   volatile ll sum{};
   ll *tmp{};
   clock_gettime(CLOCK_MONOTONIC, &beg3);
@@ -82,7 +897,7 @@ void bstar_benchmark() {
   clock_gettime(CLOCK_MONOTONIC, &end3);
   printf("test output %lld\n", sum);
 
-  std::cout << "B-star erase" << std::endl;
+  std::cout << name << " erase" << std::endl;
   clock_gettime(CLOCK_MONOTONIC, &beg2);
   for (std::size_t i = 0; i < SCALE; i++) {
     t.erase(keys[i]);
@@ -152,10 +967,1346 @@ void stdmap_benchmark() {
   delete[] keys;
 }
 
-int main() {
+// every hit reads the value, once through a separately allocated `ll`, once inline in the leaf.
+void inline_benchmark() {
+
+  puts("\n[INLINE_BENCHMARK]");
+
+  ll *keys{gen_data()};
+  std::vector<ll *> vals(SCALE);
+  for (std::size_t i = 0; i < SCALE; i++) {
+    vals[i] = new ll{static_cast<ll>(i)};
+  }
+
+  timespec beg1{}, end1{}, beg2{}, end2{};
+  volatile ll sum{};
+
+  {
+    b_star t{};
+    clock_gettime(CLOCK_MONOTONIC, &beg1);
+    for (std::size_t i = 0; i < SCALE; i++) {
+      t.insert(keys[i], vals[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end1);
+    ll s{};
+    clock_gettime(CLOCK_MONOTONIC, &beg2);
+    for (std::size_t i = 0; i < SCALE; i++) {
+      s += *t.find_single(keys[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end2);
+    sum = s;
+    printf("val_type *  insert %.3f s  find %.3f s  (%lld)\n", time_diff(beg1, end1), time_diff(beg2, end2), sum);
+  }
+
+  {
+    b_star_inline t{};
+    clock_gettime(CLOCK_MONOTONIC, &beg1);
+    for (std::size_t i = 0; i < SCALE; i++) {
+      t.insert(keys[i], static_cast<ll>(i));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end1);
+    ll s{};
+    clock_gettime(CLOCK_MONOTONIC, &beg2);
+    for (std::size_t i = 0; i < SCALE; i++) {
+      s += *t.find_single(keys[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end2);
+    sum = s;
+    printf("inline      insert %.3f s  find %.3f s  (%lld)\n", time_diff(beg1, end1), time_diff(beg2, end2), sum);
+  }
+
+  for (ll *v : vals) {
+    delete v;
+  }
+  delete[] keys;
+}
+
+// rebuilding from a sorted snapshot, per-key inserts against bulk loading.
+void bulk_load_benchmark() {
+
+  puts("\n[BULK_LOAD_BENCHMARK]");
+
+  std::vector<std::pair<ll, ll *>> snapshot(SCALE);
+  for (std::size_t i = 0; i < SCALE; i++) {
+    snapshot[i] = {static_cast<ll>(i + 1), reinterpret_cast<ll *>(i)};
+  }
+
+  timespec beg1{}, end1{}, beg2{}, end2{};
+
+  b_star t1{};
+  clock_gettime(CLOCK_MONOTONIC, &beg1);
+  for (const auto &[k, v] : snapshot) {
+    t1.insert(k, v);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end1);
+
+  b_star t2{};
+  clock_gettime(CLOCK_MONOTONIC, &beg2);
+  t2.bulk_load(snapshot.begin(), snapshot.end());
+  clock_gettime(CLOCK_MONOTONIC, &end2);
+
+  for (std::size_t i = 0; i < SCALE; i += 997) {
+    if (t2.find_single(snapshot[i].first) != snapshot[i].second) {
+      fprintf(stderr, "bulk load lost key %lld\n", snapshot[i].first);
+      _exit(-1);
+    }
+  }
+
+  std::cout << "Insert loop time: " << time_diff(beg1, end1) << " s\n";
+  std::cout << "Bulk load time:   " << time_diff(beg2, end2) << " s\n";
+}
+
+// random updates applied one key at a time against `insert_batch` / `erase_batch`.
+void batch_benchmark() {
+
+  puts("\n[BATCH_BENCHMARK]");
+
+  constexpr std::size_t BASE{SCALE / 5}, OPS{SCALE / 10};
+
+  // the tree holds the odd keys, the updates are even keys.
+  std::vector<std::pair<ll, ll *>> base(BASE);
+  for (std::size_t i = 0; i < BASE; i++) {
+    base[i] = {static_cast<ll>(2 * i + 1), reinterpret_cast<ll *>(i)};
+  }
+  std::vector<ll> upd(OPS);
+  for (std::size_t i = 0; i < OPS; i++) {
+    upd[i] = static_cast<ll>(2 * (i * (BASE / OPS)));
+  }
+  std::shuffle(upd.begin(), upd.end(), std::mt19937{1337});
+
+  auto mops = [](const timespec &beg, const timespec &end) -> double {
+    return static_cast<double>(OPS) / time_diff(beg, end) / 1e6;
+  };
+
+  timespec beg1{}, end1{}, beg2{}, end2{};
+  {
+    b_star t{base.begin(), base.end(), 0.75};
+    clock_gettime(CLOCK_MONOTONIC, &beg1);
+    for (ll k : upd) {
+      t.insert(k, reinterpret_cast<ll *>(k));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end1);
+    clock_gettime(CLOCK_MONOTONIC, &beg2);
+    for (ll k : upd) {
+      t.erase(k);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end2);
+    printf("per key        insert %6.2f Mops/s  erase %6.2f Mops/s\n", mops(beg1, end1), mops(beg2, end2));
+  }
+
+  for (std::size_t batch : {16, 64, 256, 1024, 4096, 16384, 65536, 262144, static_cast<int>(OPS)}) {
+    b_star t{base.begin(), base.end(), 0.75};
+    std::vector<std::pair<ll, ll *>> ins(batch);
+    std::vector<ll> era(batch);
+
+    clock_gettime(CLOCK_MONOTONIC, &beg1);
+    for (std::size_t i = 0; i < OPS; i += batch) {
+      std::size_t n{std::min(batch, OPS - i)};
+      for (std::size_t j = 0; j < n; j++) {
+        ins[j] = {upd[i + j], reinterpret_cast<ll *>(upd[i + j])};
+      }
+      t.insert_batch(ins.begin(), ins.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end1);
+
+    clock_gettime(CLOCK_MONOTONIC, &beg2);
+    for (std::size_t i = 0; i < OPS; i += batch) {
+      std::size_t n{std::min(batch, OPS - i)};
+      std::copy_n(upd.begin() + static_cast<std::ptrdiff_t>(i), n, era.begin());
+      t.erase_batch(era.begin(), era.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end2);
+    printf("batch %7zu  insert %6.2f Mops/s  erase %6.2f Mops/s\n", batch, mops(beg1, end1), mops(beg2, end2));
+  }
+}
+
+// node sized key arrays, scalar binary search against branchless search with a SIMD finish.
+void search_benchmark() {
+
+  puts("\n[SEARCH_BENCHMARK]");
+
+  constexpr std::size_t PROBES{1 << 22};
+  std::mt19937 gen{1337};
+
+  for (std::size_t n : {8, 16, 32, 64, 128, 144, 256, 512, 1024}) {
+    std::vector<ll> key(n);
+    for (std::size_t i = 0; i < n; i++) {
+      key[i] = static_cast<ll>(2 * i);
+    }
+    std::vector<ll> probe(PROBES);
+    std::uniform_int_distribution<ll> dist{0, static_cast<ll>(2 * n)};
+    for (auto &p : probe) {
+      p = dist(gen);
+    }
+
+    timespec beg1{}, end1{}, beg2{}, end2{};
+    std::size_t sum1{}, sum2{};
+
+    clock_gettime(CLOCK_MONOTONIC, &beg1);
+    for (std::size_t i = 0; i < PROBES; i++) {
+      sum1 += b_binary_search_<false>(key.data(), n, probe[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end1);
+
+    clock_gettime(CLOCK_MONOTONIC, &beg2);
+    for (std::size_t i = 0; i < PROBES; i++) {
+      sum2 += b_branchless_search_<false>(key.data(), n, probe[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end2);
+
+    if (sum1 != sum2) {
+      fprintf(stderr, "search mismatch\n");
+      _exit(-1);
+    }
+    printf("keys %5zu  scalar %6.2f ns  branchless+simd %6.2f ns\n", n, time_diff(beg1, end1) * 1e9 / PROBES,
+           time_diff(beg2, end2) * 1e9 / PROBES);
+  }
+}
+
+// materialized `find_range` against the lazy cursor and the visitor on the same scans.
+void range_benchmark() {
+
+  puts("\n[RANGE_BENCHMARK]");
+
+  constexpr std::size_t BASE{SCALE / 5};
+
+  std::vector<std::pair<ll, ll *>> base(BASE);
+  for (std::size_t i = 0; i < BASE; i++) {
+    base[i] = {static_cast<ll>(i), reinterpret_cast<ll *>(i)};
+  }
+  b_star t{base.begin(), base.end()};
+  std::mt19937 gen{1337};
+
+  for (std::size_t width : {16, 1024, 65536, 1048576}) {
+    std::size_t rounds{std::max<std::size_t>(4, (SCALE / 2) / width)};
+    std::vector<ll> low(rounds);
+    for (auto &l : low) {
+      l = static_cast<ll>(gen() % (BASE - width));
+    }
+
+    timespec beg1{}, end1{}, beg2{}, end2{}, beg3{}, end3{};
+    ll sum1{}, sum2{}, sum3{};
+
+    clock_gettime(CLOCK_MONOTONIC, &beg1);
+    for (ll l : low) {
+      for (ll *v : t.find_range(l, l + static_cast<ll>(width))) {
+        sum1 += reinterpret_cast<ll>(v);
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end1);
+
+    clock_gettime(CLOCK_MONOTONIC, &beg2);
+    for (ll l : low) {
+      for (auto it{t.lower_bound(l)}; it != t.end() && it.key() < l + static_cast<ll>(width); ++it) {
+        sum2 += reinterpret_cast<ll>(it.value());
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end2);
+
+    clock_gettime(CLOCK_MONOTONIC, &beg3);
+    for (ll l : low) {
+      t.for_each_in_range(l, l + static_cast<ll>(width),
+                          [&](const ll &, ll *v) { sum3 += reinterpret_cast<ll>(v); });
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end3);
+
+    if (sum1 != sum2 || sum1 != sum3) {
+      fprintf(stderr, "range mismatch\n");
+      _exit(-1);
+    }
+    printf("width %8zu  find_range %7.2f ns/key  cursor %7.2f ns/key  visitor %7.2f ns/key\n", width,
+           time_diff(beg1, end1) * 1e9 / static_cast<double>(rounds * width),
+           time_diff(beg2, end2) * 1e9 / static_cast<double>(rounds * width),
+           time_diff(beg3, end3) * 1e9 / static_cast<double>(rounds * width));
+  }
+}
+
+// random point lookups, a `find_single` loop against `find_many` over request sized batches.
+void multiget_benchmark() {
+
+  puts("\n[MULTIGET_BENCHMARK]");
+
+  constexpr std::size_t BASE{SCALE}, LOOKUPS{SCALE / 2};
+
+  std::vector<std::pair<ll, ll *>> base(BASE);
+  for (std::size_t i = 0; i < BASE; i++) {
+    base[i] = {static_cast<ll>(2 * i), reinterpret_cast<ll *>(i)};
+  }
+  b_star t{base.begin(), base.end(), 0.75};
+
+  // half of them miss.
+  std::vector<ll> keys(LOOKUPS);
+  std::mt19937_64 gen{1337};
+  for (auto &k : keys) {
+    k = static_cast<ll>(gen() % (2 * BASE));
+  }
+  std::vector<ll *> out(LOOKUPS);
+
+  timespec beg{}, end{};
+  std::size_t hit1{};
+  clock_gettime(CLOCK_MONOTONIC, &beg);
+  for (std::size_t i = 0; i < LOOKUPS; i++) {
+    out[i] = t.find_single(keys[i]);
+    hit1 += out[i] != nullptr;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("find_single        %6.2f Mops/s\n", static_cast<double>(LOOKUPS) / time_diff(beg, end) / 1e6);
+
+  for (std::size_t batch : {64, 128, 256, 512}) {
+    std::size_t hit2{};
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    for (std::size_t i = 0; i < LOOKUPS; i += batch) {
+      hit2 += t.find_many(keys.data() + i, std::min(batch, LOOKUPS - i), out.data() + i);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (hit1 != hit2) {
+      fprintf(stderr, "find_many mismatch\n");
+      _exit(-1);
+    }
+    printf("find_many %5zu    %6.2f Mops/s\n", batch, static_cast<double>(LOOKUPS) / time_diff(beg, end) / 1e6);
+  }
+}
+
+template<typename tree_type>
+void layout_run(const char *name, const ll *keys, std::size_t n) {
+  tree_type t{};
+  timespec beg1{}, end1{}, beg2{}, end2{}, beg3{}, end3{};
+  ll sum{};
+
+  clock_gettime(CLOCK_MONOTONIC, &beg1);
+  for (std::size_t i = 0; i < n; i++) {
+    t.insert(keys[i], reinterpret_cast<ll *>(i));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end1);
+
+  clock_gettime(CLOCK_MONOTONIC, &beg2);
+  for (std::size_t i = 0; i < n; i++) {
+    sum += reinterpret_cast<ll>(t.find_single(keys[i]));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end2);
+
+  clock_gettime(CLOCK_MONOTONIC, &beg3);
+  for (std::size_t i = 0; i < n; i++) {
+    t.erase(keys[i]);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end3);
+
+  printf("%-24s insert %6.3f s  find %6.3f s  erase %6.3f s  (test output %lld)\n", name, time_diff(beg1, end1),
+         time_diff(beg2, end2), time_diff(beg3, end3), sum);
+}
+
+// the hand-picked `FLOOR` against cache line aligned nodes sized to 256 B, 1 KiB and 4 KiB.
+void layout_benchmark() {
 
-  random_test();
+  puts("\n[LAYOUT_BENCHMARK]");
 
-  stdmap_benchmark();
-  bstar_benchmark();
+  ll *keys{gen_data()};
+  constexpr std::size_t N{SCALE / 2};
+
+  printf("M = %zu / %zu / %zu for 256 B / 1 KiB / 4 KiB nodes\n", FANOUT_256, FANOUT_1K, FANOUT_4K);
+  layout_run<b_star>("M = FLOOR", keys, N);
+  layout_run<b_star_aligned<FLOOR>>("M = FLOOR, aligned", keys, N);
+  layout_run<b_star_aligned<FANOUT_256>>("256 B, aligned", keys, N);
+  layout_run<b_star_aligned<FANOUT_1K>>("1 KiB, aligned", keys, N);
+  layout_run<b_star_aligned<FANOUT_4K>>("4 KiB, aligned", keys, N);
+
+  delete[] keys;
+}
+
+// 80% find, 10% insert, 10% erase per thread, the OLC tree against one mutex around `b_star`.
+void olc_benchmark() {
+
+  puts("\n[OLC_BENCHMARK]");
+
+  constexpr std::size_t BASE{SCALE / 10}, OPS{SCALE / 20};
+
+  std::vector<std::pair<ll, ll *>> base(BASE);
+  for (std::size_t i = 0; i < BASE; i++) {
+    base[i] = {static_cast<ll>(2 * i + 1), reinterpret_cast<ll *>(i)};
+  }
+
+  // `op(key, kind)` with kind 0: find, 1: insert, 2: erase, returns whether it hit.
+  std::atomic<std::size_t> hits{};
+  auto run = [&](std::size_t threads, auto &&op) -> double {
+    std::vector<std::thread> pool{};
+    timespec beg{}, end{};
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    for (std::size_t t = 0; t < threads; t++) {
+      pool.emplace_back([&, t]() {
+        std::mt19937_64 gen{1337 + t};
+        std::size_t hit{};
+        for (std::size_t i = 0; i < OPS; i++) {
+          std::uint64_t r{gen()};
+          std::size_t kind{r % 10 == 8 ? 1u : r % 10 == 9 ? 2u : 0u};
+          hit += op(static_cast<ll>((r >> 8) % (2 * BASE)), kind);
+        }
+        hits += hit;
+      });
+    }
+    for (auto &th : pool) {
+      th.join();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return static_cast<double>(threads * OPS) / time_diff(beg, end) / 1e6;
+  };
+
+  for (std::size_t threads : {1, 2, 4, 8}) {
+    double olc_mops{}, mutex_mops{};
+    {
+      b_star_olc t{};
+      t.bulk_load(base.begin(), base.end());
+      olc_mops = run(threads, [&](ll k, std::size_t kind) -> bool {
+        if (kind == 0) return t.find_single(k).has_value();
+        if (kind == 1) return t.insert(k, reinterpret_cast<ll *>(k));
+        return t.erase(k);
+      });
+    }
+    {
+      b_star t{base.begin(), base.end()};
+      std::mutex mtx{};
+      mutex_mops = run(threads, [&](ll k, std::size_t kind) -> bool {
+        std::lock_guard<std::mutex> lock{mtx};
+        if (kind == 0) return t.find_single(k) != nullptr;
+        if (kind == 1) return t.insert(k, reinterpret_cast<ll *>(k));
+        return t.erase(k);
+      });
+    }
+    printf("threads %zu  olc %6.2f Mops/s  mutex %6.2f Mops/s\n", threads, olc_mops, mutex_mops);
+  }
+  printf("test output %zu\n", hits.load());
+}
+
+template<typename tree_type>
+void string_run(const char *name, const std::vector<std::string> &keys) {
+  // the first insert of a key wins.
+  std::unordered_map<std::string, std::size_t> first{};
+  ll expected{};
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    expected += static_cast<ll>(first.try_emplace(keys[i], i).first->second);
+  }
+
+  timespec beg1{}, end1{}, beg2{}, end2{}, beg3{}, end3{};
+  ll sum{};
+  std::size_t erased{}, left{}, heap0{mallinfo2().uordblks}, bytes{};
+  {
+    tree_type t{};
+    clock_gettime(CLOCK_MONOTONIC, &beg1);
+    for (std::size_t i = 0; i < keys.size(); i++) {
+      t.insert(keys[i], reinterpret_cast<ll *>(i));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end1);
+    bytes = t.stats().reserved_bytes + (mallinfo2().uordblks - heap0);
+
+    clock_gettime(CLOCK_MONOTONIC, &beg2);
+    for (const std::string &k : keys) {
+      sum += reinterpret_cast<ll>(t.find_single(k));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end2);
+
+    clock_gettime(CLOCK_MONOTONIC, &beg3);
+    for (const std::string &k : keys) {
+      erased += t.erase(k);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end3);
+    left = t.stats().keys;
+  }
+
+  printf("%-24s insert %6.3f s  find %6.3f s  erase %6.3f s  %4zu MiB%s\n", name, time_diff(beg1, end1),
+         time_diff(beg2, end2), time_diff(beg3, end3), bytes >> 20,
+         sum == expected && erased == first.size() && left == 0 ? "" : "  MISMATCH");
+}
+
+// URL-like keys sharing long prefixes, `std::string` keys in a plain node against the slotted string node.
+void string_benchmark() {
+
+  puts("\n[STRING_BENCHMARK]");
+
+  static const char *hosts[]{"https://example.com/users/", "https://example.com/static/img/", "https://example.org/"};
+  std::mt19937_64 gen{42};
+  std::vector<std::string> keys(SCALE / 5);
+  for (std::string &k : keys) {
+    std::uint64_t v{gen() % (SCALE / 5)};
+    k = hosts[v % 3] + std::to_string(v / 3 % 1000) + "/item-" + std::to_string(v);
+  }
+
+  string_run<b_star_string>("std::string keys", keys);
+  string_run<b_star_slotted>("slotted string node", keys);
+}
+
+// a restart, rebuilding the tree by inserts against mapping an image `save()` wrote, then point lookups on both.
+void mapped_benchmark() {
+
+  puts("\n[MAPPED_BENCHMARK]");
+
+  const char *path{"bstar_tester.img"};
+  ll *keys{gen_data()};
+  timespec beg1{}, end1{}, beg2{}, end2{}, beg3{}, end3{}, beg4{}, end4{};
+  ll sum1{}, sum2{};
+
+  clock_gettime(CLOCK_MONOTONIC, &beg1);
+  b_star_inline t{};
+  for (std::size_t i = 0; i < SCALE; i++) {
+    t.insert(keys[i], static_cast<ll>(i));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end1);
+  if (!t.save(path)) {
+    puts("save failed");
+    delete[] keys;
+    return;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &beg2);
+  b_star_mapped<ll, ll, FLOOR> m{};
+  bool opened{m.open_mapped(path)};
+  clock_gettime(CLOCK_MONOTONIC, &end2);
+
+  clock_gettime(CLOCK_MONOTONIC, &beg3);
+  for (std::size_t i = 0; i < SCALE; i++) {
+    sum1 += *t.find_single(keys[i]);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end3);
+
+  clock_gettime(CLOCK_MONOTONIC, &beg4);
+  for (std::size_t i = 0; opened && i < SCALE; i++) {
+    sum2 += *m.find_single(keys[i]);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end4);
+
+  printf("startup  inserts %.3f s  open_mapped %.6f s\n", time_diff(beg1, end1), time_diff(beg2, end2));
+  printf("find     tree %.3f s  mapped %.3f s  (test output %lld %lld)\n", time_diff(beg3, end3),
+         time_diff(beg4, end4), sum1, sum2);
+  std::remove(path);
+  delete[] keys;
+}
+
+// a tree built by random inserts against its `freeze()` copy: random lookups, scans of a few widths and bytes.
+void frozen_benchmark() {
+
+  puts("\n[FROZEN_BENCHMARK]");
+
+  ll *keys{gen_data()};
+  b_star_inline t{};
+  for (std::size_t i = 0; i < SCALE; i++) {
+    t.insert(keys[i], keys[i]);
+  }
+  timespec beg{}, end{};
+
+  clock_gettime(CLOCK_MONOTONIC, &beg);
+  b_star_frozen<ll, ll> f{t.freeze()};
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("freeze %.3f s, %zu levels  bytes  tree %zu MB  frozen %zu MB\n", time_diff(beg, end), f.levels(),
+         t.stats().bytes >> 20, f.bytes() >> 20);
+
+  auto finds = [&](const auto &tree) {
+    ll sum{0};
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    for (std::size_t i = 0; i < SCALE; i++) {
+      sum += *tree.find_single(keys[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return std::pair{time_diff(beg, end) * 1e9 / static_cast<double>(SCALE), sum};
+  };
+  auto [tree_ns, tree_sum]{finds(t)};
+  auto [frozen_ns, frozen_sum]{finds(f)};
+  printf("find        tree %6.1f ns  frozen %6.1f ns%s\n", tree_ns, frozen_ns, tree_sum == frozen_sum ? "" : "  MISMATCH");
+
+  for (std::size_t width : {16, 1024, 65536}) {
+    std::size_t rounds{std::max<std::size_t>(4, (SCALE / 2) / width)};
+    auto scans = [&](const auto &tree) {
+      ll sum{0};
+      clock_gettime(CLOCK_MONOTONIC, &beg);
+      for (std::size_t i = 0; i < rounds; i++) {
+        tree.for_each_in_range(keys[i], keys[i] + static_cast<ll>(width), [&](const ll &, const ll *v) { sum += *v; });
+      }
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      return std::pair{time_diff(beg, end) * 1e9 / static_cast<double>(rounds * width), sum};
+    };
+    auto [tree_scan, tree_scan_sum]{scans(t)};
+    auto [frozen_scan, frozen_scan_sum]{scans(f)};
+    printf("width %6zu  tree %6.2f ns/key  frozen %6.2f ns/key%s\n", width, tree_scan, frozen_scan,
+           tree_scan_sum == frozen_scan_sum ? "" : "  MISMATCH");
+  }
+  delete[] keys;
+}
+
+// the counters' overhead, and what they saw over insert / find / erase of every key.
+void stats_benchmark() {
+
+  puts("\n[STATS_BENCHMARK]");
+
+  b_thread_stats<>::reset();
+  bstar_benchmark<b_star>("B-star (no stats)");
+  bstar_benchmark<b_star_stats>("B-star (thread stats)");
+  b_stats_snapshot snap{b_thread_stats<>::snapshot()};
+  for (std::size_t e = 0; e < static_cast<std::size_t>(b_event::COUNT); e++) {
+    printf("%-16s %llu\n", b_event_name(static_cast<b_event>(e)), static_cast<unsigned long long>(snap.cnt[e]));
+  }
+}
+
+void compact_report(const char *name, b_star &t, const ll *keys, std::size_t n) {
+  b_tree_stats st{t.stats()};
+  timespec beg1{}, end1{}, beg2{}, end2{};
+  ll sum{};
+  clock_gettime(CLOCK_MONOTONIC, &beg1);
+  for (auto it{t.begin()}; it != t.end(); ++it) {
+    sum += reinterpret_cast<ll>(it.value());
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end1);
+  clock_gettime(CLOCK_MONOTONIC, &beg2);
+  for (std::size_t i = 0; i < n; i++) {
+    sum += t.find_single(keys[i]) != nullptr;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end2);
+  std::size_t full{st.fill[9]};
+  printf("%-14s leaves %8zu  full %5.1f%%  adjacent %5.1f%%  %6.1f MiB  scan %6.2f ns/key  find %6.1f ns  (%lld)\n",
+         name, st.leaves, 100.0 * static_cast<double>(full) / static_cast<double>(st.leaves),
+         100.0 * static_cast<double>(st.adjacent_leaves) / static_cast<double>(st.leaves),
+         static_cast<double>(st.reserved_bytes) / (1 << 20),
+         time_diff(beg1, end1) * 1e9 / static_cast<double>(st.keys), time_diff(beg2, end2) * 1e9 / static_cast<double>(n),
+         sum % 10);
+}
+
+// random inserts then erasing every other key leave the leaves half full and scattered, then a full
+// `compact_step()` pass and a `compact()`.
+void compact_benchmark() {
+
+  puts("\n[COMPACT_BENCHMARK]");
+
+  ll *keys{gen_data()};
+  b_star t{};
+  for (std::size_t i = 0; i < SCALE; i++) {
+    t.insert(keys[i], reinterpret_cast<ll *>(keys[i]));
+  }
+  for (std::size_t i = 0; i < SCALE; i++) {
+    if (keys[i] % 2 == 0) t.erase(keys[i]);
+  }
+  constexpr std::size_t FINDS{SCALE / 5};
+  compact_report("churned", t, keys, FINDS);
+
+  timespec beg{}, end{};
+  clock_gettime(CLOCK_MONOTONIC, &beg);
+  std::size_t steps{1};
+  while (t.compact_step(64)) {
+    steps++;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("compact_step x%zu: %.3f s\n", steps, time_diff(beg, end));
+  compact_report("stepped", t, keys, FINDS);
+
+  clock_gettime(CLOCK_MONOTONIC, &beg);
+  t.compact();
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("compact: %.3f s\n", time_diff(beg, end));
+  compact_report("compacted", t, keys, FINDS);
+  delete[] keys;
+}
+
+// a secondary index, `rows` rows over `keys` keys: duplicates in a multitree against a vector per key.
+// memory is the tree's slabs plus what malloc hands out.
+void multi_run(std::size_t rows, std::size_t keys) {
+  std::mt19937_64 gen{7};
+  std::vector<ll> row(rows);
+  for (ll &r : row) {
+    r = static_cast<ll>(gen() % keys);
+  }
+  std::vector<ll> probe(keys / 10);
+  for (ll &p : probe) {
+    p = static_cast<ll>(gen() % keys);
+  }
+  printf("%zu rows, %zu keys\n", rows, keys);
+
+  timespec beg1{}, end1{}, beg2{}, end2{}, beg3{}, end3{};
+  ll sum1{}, sum2{};
+  std::size_t heap0{mallinfo2().uordblks}, bytes{};
+  {
+    b_star_multi t{};
+    clock_gettime(CLOCK_MONOTONIC, &beg1);
+    for (std::size_t i = 0; i < rows; i++) {
+      t.insert(row[i], static_cast<ll>(i));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end1);
+    bytes = t.stats().reserved_bytes + (mallinfo2().uordblks - heap0);
+    clock_gettime(CLOCK_MONOTONIC, &beg2);
+    for (ll p : probe) {
+      for (auto [it, last]{t.equal_range(p)}; it != last; ++it) {
+        sum1 += *it.value();
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end2);
+    clock_gettime(CLOCK_MONOTONIC, &beg3);
+    for (ll p : probe) {
+      t.erase_all(p);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end3);
+  }
+  printf("  %-20s insert %6.3f s  equal_range %6.3f s  erase_all %6.3f s  %7.1f MiB\n", "multitree",
+         time_diff(beg1, end1), time_diff(beg2, end2), time_diff(beg3, end3),
+         static_cast<double>(bytes) / (1 << 20));
+
+  heap0 = mallinfo2().uordblks;
+  {
+    b_star_lists t{};
+    clock_gettime(CLOCK_MONOTONIC, &beg1);
+    for (std::size_t i = 0; i < rows; i++) {
+      std::vector<ll> *list{t.find_single(row[i])};
+      if (!list) {
+        list = new std::vector<ll>{};
+        t.insert(row[i], list);
+      }
+      list->emplace_back(static_cast<ll>(i));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end1);
+    bytes = t.stats().reserved_bytes + (mallinfo2().uordblks - heap0);
+    clock_gettime(CLOCK_MONOTONIC, &beg2);
+    for (ll p : probe) {
+      if (std::vector<ll> *list{t.find_single(p)}) {
+        for (ll v : *list) {
+          sum2 += v;
+        }
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end2);
+    clock_gettime(CLOCK_MONOTONIC, &beg3);
+    for (ll p : probe) {
+      if (std::vector<ll> *list{t.find_single(p)}) {
+        t.erase(p);
+        delete list;
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end3);
+    t.for_each_in_range(0, static_cast<ll>(keys), [](const ll &, std::vector<ll> *list) { delete list; });
+  }
+  printf("  %-20s insert %6.3f s  equal_range %6.3f s  erase_all %6.3f s  %7.1f MiB\n", "std::vector per key",
+         time_diff(beg1, end1), time_diff(beg2, end2), time_diff(beg3, end3),
+         static_cast<double>(bytes) / (1 << 20));
+  if (sum1 != sum2) {
+    fprintf(stderr, "multi mismatch\n");
+    _exit(-1);
+  }
+}
+
+void multi_benchmark() {
+
+  puts("\n[MULTI_BENCHMARK]");
+
+  multi_run(SCALE / 2, SCALE / 4);
+  multi_run(SCALE / 2, SCALE / 40);
+}
+
+// a counters workload, 90% increments and 10% reads over `SCALE / 10` keys, counting the misses in:
+// a lookup plus an erase and insert to replace the count, a lookup writing through the pointer, and `update()`.
+void upsert_benchmark() {
+
+  puts("\n[UPSERT_BENCHMARK]");
+
+  constexpr std::size_t KEYS{SCALE / 10};
+  std::mt19937_64 gen{11};
+  std::vector<ll> key(SCALE);
+  std::vector<bool> read(SCALE);
+  for (std::size_t i = 0; i < SCALE; i++) {
+    key[i] = static_cast<ll>(gen() % KEYS);
+    read[i] = gen() % 10 == 0;
+  }
+
+  auto run = [&](const char *name, auto &&bump) {
+    b_star_inline t{};
+    timespec beg{}, end{};
+    ll sum{};
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    for (std::size_t i = 0; i < SCALE; i++) {
+      if (read[i]) {
+        ll *v{t.find_single(key[i])};
+        sum += v ? *v : 0;
+      } else {
+        bump(t, key[i]);
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%-26s %6.3f s  %6.1f ns/op  (test output %lld)\n", name, time_diff(beg, end),
+           time_diff(beg, end) * 1e9 / static_cast<double>(SCALE), sum);
+  };
+
+  run("find + erase + insert", [](b_star_inline &t, ll k) {
+    ll *v{t.find_single(k)};
+    ll c{v ? *v + 1 : 1};
+    if (v) t.erase(k);
+    t.insert(k, c);
+  });
+  run("find + write, insert", [](b_star_inline &t, ll k) {
+    if (ll *v{t.find_single(k)}) {
+      ++*v;
+    } else {
+      t.insert(k, 1);
+    }
+  });
+  run("update", [](b_star_inline &t, ll k) { t.update(k, 0, [](ll *v) { ++*v; }); });
+}
+
+// time-ordered ingest, `SCALE` ascending keys through `insert()` and through `insert_hint()`, and how full the leaves end.
+void append_benchmark() {
+
+  puts("\n[APPEND_BENCHMARK]");
+
+  auto report = [](const char *name, const timespec &beg, const timespec &end, const b_star_inline &t) {
+    b_tree_stats st{t.stats()};
+    printf("%-14s %6.3f s  %6.1f ns/key  %6.1f keys/leaf  %6.1f MiB\n", name, time_diff(beg, end),
+           time_diff(beg, end) * 1e9 / static_cast<double>(SCALE),
+           static_cast<double>(st.keys) / static_cast<double>(st.leaves), static_cast<double>(st.bytes) / (1 << 20));
+  };
+
+  timespec beg{}, end{};
+  {
+    b_star_inline t{};
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    for (std::size_t i = 0; i < SCALE; i++) {
+      t.insert(static_cast<ll>(i), static_cast<ll>(i));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    report("insert", beg, end, t);
+  }
+  {
+    b_star_inline t{};
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    b_star_inline::cursor hint{t.end()};
+    for (std::size_t i = 0; i < SCALE; i++) {
+      hint = t.insert_hint(hint, static_cast<ll>(i), static_cast<ll>(i));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    report("insert_hint", beg, end, t);
+  }
+}
+
+// `SCALE / 50` random keys, then rounds of erasing every other one and inserting them back: the leaves drop
+// under `MIN_KEYS` and fill up again. erases fix nodes at `MIN_KEYS`, or at a low water of 2 or 24 keys.
+void churn_benchmark() {
+
+  puts("\n[CHURN_BENCHMARK]");
+
+  ll *keys{gen_data()};
+  constexpr std::size_t LIVE{SCALE / 50};
+  constexpr std::size_t ROUNDS{30};
+
+  auto report = [](const char *name, double secs, std::size_t ops, const b_star_stats &t) {
+    b_stats_snapshot snap{b_thread_stats<>::snapshot()};
+    b_tree_stats st{t.stats()};
+    printf("%-14s %8.2f ms  %6.1f ns/op  merges %7llu  splits %7llu  equal splits %7llu  moved %7.1f MiB  "
+           "%6.1f keys/leaf\n",
+           name, secs * 1e3, ops ? secs * 1e9 / static_cast<double>(ops) : 0.0,
+           static_cast<unsigned long long>(snap[b_event::MERGE_2_1] + snap[b_event::MERGE_3_2]),
+           static_cast<unsigned long long>(snap[b_event::SPLIT_1_2] + snap[b_event::SPLIT_2_3]),
+           static_cast<unsigned long long>(snap[b_event::EQUAL_SPLIT_2] + snap[b_event::EQUAL_SPLIT_3]),
+           static_cast<double>(snap[b_event::MOVED_BYTES]) / (1 << 20),
+           static_cast<double>(st.keys) / static_cast<double>(st.leaves));
+  };
+
+  for (std::size_t low_water : {std::size_t{0}, std::size_t{2}, std::size_t{24}}) {
+    b_star_stats t{};
+    if (low_water) t.set_low_water(low_water);
+    for (std::size_t i = 0; i < LIVE; i++) {
+      t.insert(keys[i], reinterpret_cast<ll *>(keys[i]));
+    }
+    b_thread_stats<>::reset();
+    timespec beg{}, end{};
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    for (std::size_t r = 0; r < ROUNDS; r++) {
+      for (std::size_t i = r % 2; i < LIVE; i += 2) {
+        t.erase(keys[i]);
+      }
+      for (std::size_t i = r % 2; i < LIVE; i += 2) {
+        t.insert(keys[i], reinterpret_cast<ll *>(keys[i]));
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    char name[32];
+    snprintf(name, sizeof(name), low_water ? "low water %zu" : "MIN_KEYS", low_water);
+    report(name, time_diff(beg, end), ROUNDS * LIVE, t);
+    if (!low_water) continue;
+
+    // the same tree half empty, as a batch of erases would leave it, caught up in one pass.
+    for (std::size_t i = 0; i < LIVE; i += 2) {
+      t.erase(keys[i]);
+    }
+    b_thread_stats<>::reset();
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    t.rebalance();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    report("  rebalance()", time_diff(beg, end), 0, t);
+  }
+  delete[] keys;
+}
+
+// TTL expiry: `SCALE` timestamps, then the oldest `SCALE / 2` expired a window of `SCALE / 100` at a time,
+// per key, through `erase_batch()` and through `erase_range()`. each window is a pause foreground traffic waits on.
+void expire_benchmark() {
+
+  puts("\n[EXPIRE_BENCHMARK]");
+
+  constexpr std::size_t WINDOW{SCALE / 100}, WINDOWS{50};
+  std::vector<std::pair<ll, ll>> rows(SCALE);
+  for (std::size_t i = 0; i < SCALE; i++) {
+    rows[i] = {static_cast<ll>(i), static_cast<ll>(i)};
+  }
+
+  auto run = [&](const char *name, auto &&expire) {
+    b_star_inline t{rows.begin(), rows.end()};
+    timespec beg{}, end{};
+    std::vector<double> took(WINDOWS);
+    std::size_t erased{0};
+    for (std::size_t w = 0; w < WINDOWS; w++) {
+      clock_gettime(CLOCK_MONOTONIC, &beg);
+      erased += expire(t, static_cast<ll>(w * WINDOW), static_cast<ll>((w + 1) * WINDOW));
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      took[w] = time_diff(beg, end);
+    }
+    double total{std::accumulate(took.begin(), took.end(), 0.0)};
+    std::sort(took.begin(), took.end());
+    b_tree_stats st{t.stats()};
+    printf("%-12s %7.3f s  %6.2f ns/key  window median %7.3f ms  max %7.3f ms  (%zu erased, %zu left in %zu leaves)\n",
+           name, total, total * 1e9 / static_cast<double>(erased), took[WINDOWS / 2] * 1e3, took.back() * 1e3, erased,
+           st.keys, st.leaves);
+  };
+
+  run("per key", [](b_star_inline &t, ll low, ll high) {
+    std::size_t n{0};
+    for (ll k = low; k < high; k++) {
+      n += t.erase(k);
+    }
+    return n;
+  });
+  std::vector<ll> batch(WINDOW);
+  run("erase_batch", [&](b_star_inline &t, ll low, ll high) {
+    std::iota(batch.begin(), batch.begin() + (high - low), low);
+    return t.erase_batch(batch.begin(), batch.begin() + (high - low), true);
+  });
+  run("erase_range", [](b_star_inline &t, ll low, ll high) { return t.erase_range(low, high); });
+}
+
+// scaling of `bulk_load_parallel()` from shuffled and from sorted input, and of `reduce_range()` summing all or half
+// of the values, from 1 thread up to the cores there are, next to the serial sort + `bulk_load()` and scan.
+void parallel_benchmark() {
+
+  puts("\n[PARALLEL_BENCHMARK]");
+
+  std::vector<std::pair<ll, ll>> rows(SCALE);
+  for (std::size_t i = 0; i < SCALE; i++) {
+    rows[i] = {static_cast<ll>(i), static_cast<ll>(i)};
+  }
+  std::shuffle(rows.begin(), rows.end(), std::mt19937_64{7});
+  std::vector<std::pair<ll, ll>> sorted_rows{rows};
+  std::sort(sorted_rows.begin(), sorted_rows.end());
+  std::size_t cores{std::max<std::size_t>(std::thread::hardware_concurrency(), 1)};
+  printf("%zu hardware threads\n", cores);
+
+  timespec beg{}, end{};
+  std::vector<std::pair<ll, ll>> input{};
+  auto load = [&](b_star_inline &t, const std::vector<std::pair<ll, ll>> &from, auto &&build) {
+    input = from;
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    build(t);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return time_diff(beg, end);
+  };
+  ll lo{static_cast<ll>(SCALE / 4)}, hi{static_cast<ll>(3 * SCALE / 4)};
+  auto sum = [](ll &acc, ll, ll *v) { acc += *v; };
+  auto add = [](ll &acc, ll part) { acc += part; };
+  auto scan = [&](b_star_inline &t, ll low, ll high, auto &&fold) {
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    ll total{fold(t, low, high)};
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (total != (high - low) * (low + high - 1) / 2) puts("wrong sum");
+    return time_diff(beg, end) * 1e3;
+  };
+
+  {
+    b_star_inline t{};
+    double shuffled{load(t, rows, [&](b_star_inline &t) {
+      std::stable_sort(input.begin(), input.end());
+      t.bulk_load(input.begin(), input.end());
+    })};
+    double sorted{load(t, sorted_rows, [&](b_star_inline &t) { t.bulk_load(input.begin(), input.end()); })};
+    auto serial = [](b_star_inline &t, ll low, ll high) {
+      ll acc{0};
+      t.for_each_in_range(low, high, [&](ll, ll *v) { acc += *v; });
+      return acc;
+    };
+    printf("serial      build shuffled %7.3f s  sorted %7.3f s  sum all %7.2f ms  half %7.2f ms\n", shuffled, sorted,
+           scan(t, 0, static_cast<ll>(SCALE), serial), scan(t, lo, hi, serial));
+  }
+
+  // the same builds and sums counted by `b_thread_stats`, the workers' counts must reach this thread.
+  using counted_node = b_star_inline_node<ll, ll, FLOOR>;
+  using counted = b_star_tree<ll, ll, FLOOR, counted_node, b_node_arena<counted_node>, b_thread_stats<>>;
+  std::vector<std::pair<ll, ll>> few(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(SCALE / 10));
+  std::vector<std::size_t> counts{1, 2, 4, 8};
+  if (cores > 8) counts.emplace_back(cores);
+  std::array<double, 4> base{};
+  for (std::size_t threads : counts) {
+    b_star_inline t{};
+    double shuffled{load(t, rows, [&](b_star_inline &t) { t.bulk_load_parallel(input.begin(), input.end(), threads); })};
+    double sorted{load(t, sorted_rows, [&](b_star_inline &t) {
+      t.bulk_load_parallel(input.begin(), input.end(), threads, 1.0, true);
+    })};
+    auto parallel = [&](b_star_inline &t, ll low, ll high) { return t.reduce_range(low, high, ll{0}, sum, add, threads); };
+    std::array<double, 4> took{shuffled, sorted, scan(t, 0, static_cast<ll>(SCALE), parallel),
+                               scan(t, lo, hi, parallel)};
+    if (threads == 1) base = took;
+    printf("threads %3zu build shuffled %7.3f s x%4.2f  sorted %7.3f s x%4.2f  sum all %7.2f ms x%4.2f  "
+           "half %7.2f ms x%4.2f%s\n",
+           threads, took[0], base[0] / took[0], took[1], base[1] / took[1], took[2], base[2] / took[2], took[3],
+           base[3] / took[3], threads > cores ? "  (more threads than cores)" : "");
+
+    counted c{};
+    input = few;
+    b_thread_stats<>::reset();
+    c.bulk_load_parallel(input.begin(), input.end(), threads);
+    std::uint64_t alloc{b_thread_stats<>::snapshot()[b_event::NODE_ALLOC]};
+    b_thread_stats<>::reset();
+    constexpr std::uint64_t SUMS{8};
+    for (std::uint64_t i = 0; i < SUMS; i++) {
+      c.reduce_range(0, static_cast<ll>(few.size()), ll{0}, sum, add, threads);
+    }
+    std::uint64_t descents{b_thread_stats<>::snapshot()[b_event::DESCENTS]};
+    if (alloc != c.stats().nodes || descents != SUMS) {
+      fprintf(stderr, "threads %zu: %llu nodes allocated for %zu, %llu descents for %llu sums, MISMATCH\n", threads,
+              static_cast<unsigned long long>(alloc), c.stats().nodes, static_cast<unsigned long long>(descents),
+              static_cast<unsigned long long>(SUMS));
+    }
+  }
+}
+
+// counts and sums over ranges of growing width, `find_range()` + a loop and `for_each_in_range()` on a plain tree
+// against `count_range()` / `aggregate_range()` on `b_star_counted`, then what keeping the summaries costs a write.
+void augmented_benchmark() {
+
+  puts("\n[AUGMENTED_BENCHMARK]");
+
+  constexpr std::size_t N{SCALE / 2}, QUERIES{200};
+  std::vector<std::pair<ll, ll>> rows(N);
+  for (std::size_t i = 0; i < N; i++) {
+    rows[i] = {static_cast<ll>(2 * i), static_cast<ll>(i % 1000)};
+  }
+  b_star_inline plain{rows.begin(), rows.end()};
+  b_star_counted counted{rows.begin(), rows.end()};
+  std::mt19937_64 gen{11};
+  timespec beg{}, end{};
+
+  for (std::size_t width : {100, 10000, 1000000}) {
+    std::vector<ll> lows(QUERIES);
+    for (ll &low : lows) {
+      low = static_cast<ll>(gen() % (2 * (N - width)));
+    }
+    auto run = [&](auto &&query) {
+      ll check{0};
+      clock_gettime(CLOCK_MONOTONIC, &beg);
+      for (ll low : lows) {
+        check += query(low, low + 2 * static_cast<ll>(width));
+      }
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      return std::pair{time_diff(beg, end) * 1e6 / QUERIES, check};
+    };
+    auto [collect_us, collect]{run([&](ll low, ll high) {
+      ll sum{0};
+      for (ll *v : plain.find_range(low, high)) {
+        sum += *v;
+      }
+      return sum;
+    })};
+    auto [visit_us, visit]{run([&](ll low, ll high) {
+      ll sum{0};
+      plain.for_each_in_range(low, high, [&](ll, ll *v) { sum += *v; });
+      return sum;
+    })};
+    auto [agg_us, agg]{run([&](ll low, ll high) { return counted.aggregate_range(low, high); })};
+    auto [count_us, count]{run([&](ll low, ll high) { return static_cast<ll>(counted.count_range(low, high)); })};
+    printf("width %8zu  sum: find_range %9.2f us  for_each %9.2f us  aggregate_range %6.2f us  count_range %6.2f us%s\n",
+           width, collect_us, visit_us, agg_us, count_us,
+           collect == visit && visit == agg && count == static_cast<ll>(QUERIES * width) ? "" : "  MISMATCH");
+  }
+
+  std::vector<std::size_t> ranks(QUERIES * 100);
+  for (std::size_t &r : ranks) {
+    r = gen() % N;
+  }
+  std::size_t hits{0};
+  clock_gettime(CLOCK_MONOTONIC, &beg);
+  for (std::size_t r : ranks) {
+    hits += counted.rank(counted.select(r).key()) == r;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("select + rank  %6.0f ns/pair  (%zu of %zu round trips)\n",
+         time_diff(beg, end) * 1e9 / static_cast<double>(ranks.size()), hits, ranks.size());
+
+  // odd keys in and out again, random order.
+  std::vector<ll> keys(N / 5);
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    keys[i] = static_cast<ll>(2 * (gen() % N) + 1);
+  }
+  auto churn = [&](auto &t) {
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    for (ll k : keys) {
+      t.insert(k, k);
+    }
+    for (ll k : keys) {
+      t.erase(k);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return time_diff(beg, end) * 1e9 / static_cast<double>(2 * keys.size());
+  };
+  double plain_ns{churn(plain)};
+  double counted_ns{churn(counted)};
+  b_tree_stats ps{plain.stats()}, cs{counted.stats()};
+  printf("insert + erase  plain %6.1f ns/op  counted %6.1f ns/op  nodes %zu B vs %zu B, %.1f vs %.1f MiB\n", plain_ns,
+         counted_ns, ps.bytes / std::max<std::size_t>(ps.nodes, 1), cs.bytes / std::max<std::size_t>(cs.nodes, 1),
+         static_cast<double>(ps.bytes) / (1 << 20), static_cast<double>(cs.bytes) / (1 << 20));
+}
+
+// random inserts into buffered trees of a few limits against the plain tree, then finds with the messages still
+// in the buffers and again after `flush()`.
+void buffered_benchmark() {
+
+  puts("\n[BUFFERED_BENCHMARK]");
+
+  std::vector<ll> keys(SCALE);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64{17});
+  timespec beg{}, end{};
+  auto per_key = [&]() { return time_diff(beg, end) * 1e9 / static_cast<double>(SCALE); };
+
+  {
+    b_star_inline plain{};
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    for (ll k : keys) {
+      plain.insert(k, k);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double insert_ns{per_key()};
+    ll sum{0};
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    for (ll k : keys) {
+      sum += *plain.find_single(k);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("plain            insert %6.1f ns/op  find %6.1f ns/op%s\n", insert_ns, per_key(),
+           sum == static_cast<ll>(SCALE) * static_cast<ll>(SCALE - 1) / 2 ? "" : "  MISMATCH");
+  }
+
+  for (std::size_t limit : {FLOOR / 2, FLOOR, 4 * FLOOR, 16 * FLOOR}) {
+    b_star_buffered t{};
+    t.set_buffer_limit(limit);
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    for (ll k : keys) {
+      t.insert(k, k);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double insert_ns{per_key()};
+    std::size_t pending{t.pending()};
+    auto finds = [&]() {
+      ll sum{0};
+      clock_gettime(CLOCK_MONOTONIC, &beg);
+      for (ll k : keys) {
+        sum += *t.find_single(k);
+      }
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      return sum == static_cast<ll>(SCALE) * static_cast<ll>(SCALE - 1) / 2 ? per_key() : -1.0;
+    };
+    double buffered_find_ns{finds()};
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    t.flush();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double flush_ms{time_diff(beg, end) * 1e3};
+    double flushed_find_ns{finds()};
+    // the pending messages still owe their way into the leaves, `flush()` pays it all at once.
+    printf("limit %5zu      insert %6.1f ns/op (%6.1f with the flush)  find %6.1f ns/op, %zu pending  flush %7.1f ms"
+           "  find %6.1f ns/op\n",
+           limit, insert_ns, insert_ns + flush_ms * 1e6 / static_cast<double>(SCALE), buffered_find_ns, pending,
+           flush_ms, flushed_find_ns);
+  }
+}
+
+// long scans next to a writer: what `snapshot()` costs, what writes pay while one is open, then a full scan of a
+// snapshot on its own thread while the writer keeps going, against a plain scan that holds the writer off.
+void cow_benchmark() {
+
+  puts("\n[COW_BENCHMARK]");
+
+  constexpr std::size_t N{SCALE / 2}, SNAPSHOTS{100000};
+  std::vector<std::pair<ll, ll>> rows(N);
+  for (std::size_t i = 0; i < N; i++) {
+    rows[i] = {static_cast<ll>(2 * i), static_cast<ll>(i)};
+  }
+  const ll expected{static_cast<ll>(N) * static_cast<ll>(N - 1) / 2};
+  b_star_inline plain{rows.begin(), rows.end()};
+  b_star_cow cow{rows.begin(), rows.end()};
+  std::mt19937_64 gen{13};
+  timespec beg{}, end{};
+
+  // odd keys in and out again, random order.
+  std::vector<ll> keys(N / 5);
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    keys[i] = static_cast<ll>(2 * (gen() % N) + 1);
+  }
+  auto churn = [&](auto &t) {
+    clock_gettime(CLOCK_MONOTONIC, &beg);
+    for (ll k : keys) {
+      t.insert(k, k);
+    }
+    for (ll k : keys) {
+      t.erase(k);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return time_diff(beg, end) * 1e9 / static_cast<double>(2 * keys.size());
+  };
+  auto copies = [&]() {
+    return static_cast<double>(b_thread_stats<>::snapshot()[b_event::NODE_COPY]) / static_cast<double>(2 * keys.size());
+  };
+
+  double plain_ns{churn(plain)};
+  b_thread_stats<>::reset();
+  double cow_ns{churn(cow)};
+  printf("insert + erase  plain %6.1f ns/op  cow %6.1f ns/op  %.2f copies/op\n", plain_ns, cow_ns, copies());
+
+  clock_gettime(CLOCK_MONOTONIC, &beg);
+  for (std::size_t i = 0; i < SNAPSHOTS; i++) {
+    cow.snapshot().close();
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("snapshot() + close()  %6.1f ns\n", time_diff(beg, end) * 1e9 / SNAPSHOTS);
+
+  {
+    b_star_cow::view snap{cow.snapshot()};
+    b_thread_stats<>::reset();
+    double held_ns{churn(cow)};
+    printf("insert + erase  snapshot open %6.1f ns/op  %.2f copies/op  retired %zu nodes", held_ns, copies(),
+           cow.retired_nodes());
+    snap.close();
+    printf(", %zu after close\n", cow.retired_nodes());
+  }
+
+  // the plain tree has to stop writing for as long as the scan takes.
+  ll sum{0};
+  clock_gettime(CLOCK_MONOTONIC, &beg);
+  plain.for_each_in_range(0, static_cast<ll>(2 * N), [&](ll, ll *v) { sum += *v; });
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("full scan  plain, writer waits %8.2f ms%s\n", time_diff(beg, end) * 1e3, sum == expected ? "" : "  MISMATCH");
+
+  std::atomic<bool> done{false};
+  double scan_ms{0};
+  sum = 0;
+  b_star_cow::view snap{cow.snapshot()};
+  std::thread reader{[&]() {
+    timespec b{}, e{};
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    snap.for_each([&](ll, const ll *v) { sum += *v; });
+    clock_gettime(CLOCK_MONOTONIC, &e);
+    scan_ms = time_diff(b, e) * 1e3;
+    done.store(true, std::memory_order_release);
+  }};
+  std::size_t writes{0};
+  for (std::size_t i = 0; !done.load(std::memory_order_acquire); i = (i + 1) % keys.size()) {
+    cow.insert(keys[i], keys[i]);
+    cow.erase(keys[i]);
+    writes += 2;
+  }
+  reader.join();
+  std::size_t retired{cow.retired_nodes()};
+  snap.close();
+  printf("full scan  snapshot, writer goes on %8.2f ms, %zu writes meanwhile, retired %zu nodes, %zu after close%s\n",
+         scan_ms, writes, retired, cow.retired_nodes(), sum == expected ? "" : "  MISMATCH");
+}
+
+// durable inserts against the commit window, each thread inserting its own keys for a fixed time.
+void wal_benchmark() {
+
+  puts("\n[WAL_BENCHMARK]");
+
+  const char *path{"bstar_tester.wal"};
+  constexpr double SECONDS{0.5};
+
+  for (std::size_t threads : {1, 4, 16, 64}) {
+    for (long window : {0L, 50L, 200L, 1000L}) {
+      std::remove(path);
+      b_star_durable<ll, ll, FLOOR> t{};
+      if (!t.open(path, {std::chrono::microseconds{window}})) {
+        puts("open failed");
+        return;
+      }
+      std::atomic<std::size_t> commits{};
+      std::atomic<bool> stop{};
+      std::vector<std::thread> pool{};
+      timespec beg{}, end{};
+      clock_gettime(CLOCK_MONOTONIC, &beg);
+      for (std::size_t th = 0; th < threads; th++) {
+        pool.emplace_back([&, th]() {
+          std::size_t done{};
+          for (ll k = static_cast<ll>(th); !stop.load(std::memory_order_relaxed); k += static_cast<ll>(threads)) {
+            done += t.insert(k, k);
+          }
+          commits += done;
+        });
+      }
+      std::this_thread::sleep_for(std::chrono::duration<double>{SECONDS});
+      stop = true;
+      for (auto &th : pool) {
+        th.join();
+      }
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      double secs{time_diff(beg, end)};
+      printf("threads %2zu  window %4ld us  %9.0f commits/s  %7.0f syncs/s  %6.1f per sync\n", threads, window,
+             static_cast<double>(commits) / secs, static_cast<double>(t.syncs_done()) / secs,
+             static_cast<double>(commits) / static_cast<double>(std::max<std::uint64_t>(t.syncs_done(), 1)));
+    }
+  }
+  std::remove(path);
+}
+
+int main(int argc, char **argv) {
+
+  // no argument runs everything, otherwise only the named parts.
+  auto wanted = [&](const char *name) -> bool {
+    if (argc < 2) return true;
+    for (int i = 1; i < argc; i++) {
+      if (std::strcmp(argv[i], name) == 0) return true;
+    }
+    return false;
+  };
+
+  if (wanted("random")) random_test();
+  if (wanted("compact_test")) compact_test();
+  if (wanted("frozen_test")) frozen_test();
+  if (wanted("wal_test")) wal_test();
+  if (wanted("mapped_test")) mapped_test();
+  if (wanted("string_test")) string_test();
+  if (wanted("olc_test")) olc_test();
+  if (wanted("augmented_test")) augmented_test();
+  if (wanted("buffered_test")) buffered_test();
+  if (wanted("cow_test")) cow_test();
+
+  if (wanted("stdmap")) stdmap_benchmark();
+  if (wanted("bstar")) {
+    bstar_benchmark<b_star>("B-star (arena)");
+    bstar_benchmark<b_star_heap>("B-star (new/delete)");
+  }
+  if (wanted("search")) search_benchmark();
+  if (wanted("bulk")) bulk_load_benchmark();
+  if (wanted("batch")) batch_benchmark();
+  if (wanted("inline")) inline_benchmark();
+  if (wanted("range")) range_benchmark();
+  if (wanted("multiget")) multiget_benchmark();
+  if (wanted("layout")) layout_benchmark();
+  if (wanted("olc")) olc_benchmark();
+  if (wanted("string")) string_benchmark();
+  if (wanted("mapped")) mapped_benchmark();
+  if (wanted("frozen")) frozen_benchmark();
+  if (wanted("wal")) wal_benchmark();
+  if (wanted("stats")) stats_benchmark();
+  if (wanted("compact")) compact_benchmark();
+  if (wanted("multi")) multi_benchmark();
+  if (wanted("upsert")) upsert_benchmark();
+  if (wanted("append")) append_benchmark();
+  if (wanted("churn")) churn_benchmark();
+  if (wanted("expire")) expire_benchmark();
+  if (wanted("parallel")) parallel_benchmark();
+  if (wanted("augmented")) augmented_benchmark();
+  if (wanted("buffered")) buffered_benchmark();
+  if (wanted("cow")) cow_benchmark();
 }
\ No newline at end of file